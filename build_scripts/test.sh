@@ -4,4 +4,7 @@
 ##config.sh and functions.sh must be included in caller script
 #end configs
 
-$dirbuild/$exename $dirtests/01.py
+for ftest in $dirtests/*.py; do
+    $dirbuild/$exename $ftest
+    fn_stoponerror "$?" $LINENO
+done
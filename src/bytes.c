@@ -0,0 +1,315 @@
+/* File: Bytes
+ * Mutable byte arrays returned by bytearray().
+ *
+ * A bytearray is a view, off and len, of a reference counted buffer.
+ * Slicing makes a new view of the same buffer, so b[4:8] copies nothing and
+ * writes through either view are seen by both, until one of them grows.
+ */
+
+typedef struct type_vmBuffer {
+    int refs;
+    int len;
+    int alloc;
+    unsigned char *s;
+} type_vmBuffer;
+
+typedef struct type_vmBytes {
+    type_vmBuffer *buf;
+    int off;
+    int len;
+} type_vmBytes;
+
+type_vmObj vm_bytes_view(type_vm *tp, type_vmBuffer *buf, int off, int len);
+
+vm_inline static type_vmBytes *vm_bytes_of(type_vmObj self) {
+    return (type_vmBytes*)self.data.val;
+}
+
+vm_inline static type_vmBytes *vm_bytes_self(type_vm *tp) {
+    return vm_bytes_of(vm_operations_get(tp,tp->params,vm_none));
+}
+
+vm_inline static unsigned char *vm_bytes_ptr(type_vmBytes *self) {
+    return self->buf->s+self->off;
+}
+
+/* Byte offset of index k into self, raising for anything out of range. */
+static int vm_bytes_index(type_vm *tp, type_vmBytes *self, type_vmObj k, int size) {
+    int n = vm_typecheck(tp,vm_enum1_number,k).number.val;
+    n = n < 0 ? self->len+n : n;
+    if (n < 0 || n+size > self->len) {
+        vm_raise(tp,vm_string("(vm_bytes_index) IndexError: bytearray index out of range"));
+    }
+    return n;
+}
+
+/* Makes room for n more bytes at the end of self. A view that shares its
+ * buffer, or ends before the buffer does, is first copied to a buffer of
+ * its own, so growing one bytearray never shows through another. */
+static void vm_bytes_reserve(type_vm *tp, type_vmBytes *self, int n) {
+    type_vmBuffer *buf = self->buf;
+    if (!n) { return; }
+    if (buf->refs > 1 || self->off+self->len != buf->len) {
+        type_vmBuffer *own = (type_vmBuffer*)calloc(sizeof(type_vmBuffer),1);/*calloc((x),1)*/
+        own->refs = 1;
+        own->len = self->len;
+        own->alloc = vm_max(16,self->len+n);
+        own->s = (unsigned char*)malloc(own->alloc);/*malloc(x)*/
+        if (self->len) { memcpy(own->s,vm_bytes_ptr(self),self->len); }
+        if (--buf->refs == 0) {
+            free(buf->s);
+            free(buf);
+        }
+        self->buf = own;
+        self->off = 0;
+        return;
+    }
+    if (buf->len+n > buf->alloc) {
+        buf->alloc = vm_max(vm_max(16,buf->alloc*2),buf->len+n);
+        buf->s = (unsigned char*)realloc(buf->s,buf->alloc);/*realloc(x,y)*/
+    }
+}
+
+static void vm_bytes_write(type_vm *tp, type_vmBytes *self, void const *s, int n) {
+    vm_bytes_reserve(tp,self,n);
+    if (n) { memcpy(self->buf->s+self->buf->len,s,n); }
+    self->buf->len += n;
+    self->len += n;
+}
+
+static int vm_bytes_byte(type_vm *tp, type_vmObj v) {
+    int c = vm_typecheck(tp,vm_enum1_number,v).number.val;
+    if (c < 0 || c > 255) {
+        vm_raise(tp,vm_string("(vm_bytes_byte) ValueError: byte must be in range(0, 256)"));
+    }
+    return c;
+}
+
+/* Appends the bytes of a string, a bytearray or a list of numbers. */
+static void vm_bytes_extend_sub(type_vm *tp, type_vmBytes *self, type_vmObj v) {
+    int i;
+    if (v.type == vm_enum1_string) {
+        vm_bytes_write(tp,self,v.string.val,v.string.len);
+    } else if (v.type == vm_enum1_data && v.data.magic == vm_enum3_bytes) {
+        type_vmBytes *o = vm_bytes_of(v);
+        int n = o->len;
+        vm_bytes_reserve(tp,self,n);
+        /* the buffer may have moved, and may be o's own */
+        if (n) { memmove(self->buf->s+self->buf->len,vm_bytes_ptr(o),n); }
+        self->buf->len += n;
+        self->len += n;
+    } else {
+        vm_typecheck(tp,vm_enum1_list,v);
+        vm_bytes_reserve(tp,self,v.list.val->len);
+        for (i=0; i<v.list.val->len; i++) {
+            unsigned char c = (unsigned char)vm_bytes_byte(tp,vm_list_at(v.list.val,i));
+            vm_bytes_write(tp,self,&c,1);
+        }
+    }
+}
+
+/* Parses a pack format: an optional '<' (default) or '>' for the byte
+ * order, then one of bBhHiIfd. Returns the size of the value. */
+static int vm_bytes_format(type_vm *tp, type_vmObj fmt, int *big, char *code) {
+    char const *s = fmt.string.val;
+    int n = fmt.string.len;
+    *big = 0;
+    if (n == 2 && (s[0] == '<' || s[0] == '>')) { *big = s[0] == '>'; s++; n--; }
+    if (n == 1) {
+        *code = s[0];
+        switch (s[0]) {
+            case 'b': case 'B': return 1;
+            case 'h': case 'H': return 2;
+            case 'i': case 'I': case 'f': return 4;
+            case 'd': return 8;
+        }
+    }
+    vm_raise(tp,vm_string("(vm_bytes_format) ValueError: bad pack format"));
+    return 0;
+}
+
+/* Copies n bytes between value order and memory order. */
+static void vm_bytes_order(unsigned char *d, unsigned char const *s, int n, int big) {
+    int one = 1, i;
+    int swap = big == *(char*)&one;
+    for (i=0; i<n; i++) { d[i] = s[swap ? n-1-i : i]; }
+}
+
+/* b.pack(fmt, offset, value) writes value at offset. */
+type_vmObj vm_bytes_pack(type_vm *tp) {
+    type_vmBytes *self = vm_bytes_self(tp);
+    type_vmObj fmt = vm_typecheck(tp,vm_enum1_string,vm_operations_get(tp,tp->params,vm_none));
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    type_vmNum v = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;
+    int big, size, at;
+    char code;
+    unsigned char b[8];
+    size = vm_bytes_format(tp,fmt,&big,&code);
+    at = vm_bytes_index(tp,self,o,size);
+    if (code == 'f') {
+        float f = (float)v;
+        memcpy(b,&f,4);
+        vm_bytes_order(vm_bytes_ptr(self)+at,b,4,big);
+    } else if (code == 'd') {
+        memcpy(b,&v,8);
+        vm_bytes_order(vm_bytes_ptr(self)+at,b,8,big);
+    } else {
+        unsigned long u;
+        int i;
+        if (code >= 'a' ? v < -ldexp(1.0,8*size-1) || v >= ldexp(1.0,8*size-1)
+                        : v < 0 || v >= ldexp(1.0,8*size)) {
+            vm_raise(tp,vm_string("(vm_bytes_pack) ValueError: value out of range for pack format"));
+        }
+        u = v < 0 ? (unsigned long)(long)v : (unsigned long)v;
+        for (i=0; i<size; i++) { b[big ? size-1-i : i] = (unsigned char)(u>>(8*i)); }
+        memcpy(vm_bytes_ptr(self)+at,b,size);
+    }
+    return vm_none;
+}
+
+/* b.unpack(fmt, offset) reads a value from offset. */
+type_vmObj vm_bytes_unpack(type_vm *tp) {
+    type_vmBytes *self = vm_bytes_self(tp);
+    type_vmObj fmt = vm_typecheck(tp,vm_enum1_string,vm_operations_get(tp,tp->params,vm_none));
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    int big, at, size, i;
+    char code;
+    unsigned char b[8];
+    unsigned long u = 0;
+    size = vm_bytes_format(tp,fmt,&big,&code);
+    at = vm_bytes_index(tp,self,o,size);
+    if (code == 'f') {
+        float f;
+        vm_bytes_order(b,vm_bytes_ptr(self)+at,4,big);
+        memcpy(&f,b,4);
+        return vm_create_numericObj(f);
+    } else if (code == 'd') {
+        type_vmNum d;
+        vm_bytes_order(b,vm_bytes_ptr(self)+at,8,big);
+        memcpy(&d,b,8);
+        return vm_create_numericObj(d);
+    }
+    memcpy(b,vm_bytes_ptr(self)+at,size);
+    for (i=0; i<size; i++) { u |= (unsigned long)b[big ? size-1-i : i]<<(8*i); }
+    if (code >= 'a' && (u>>(8*size-1))&1) {
+        return vm_create_numericObj((type_vmNum)u-ldexp(1.0,8*size));
+    }
+    return vm_create_numericObj((type_vmNum)u);
+}
+
+type_vmObj vm_bytes_append(type_vm *tp) {
+    type_vmBytes *self = vm_bytes_self(tp);
+    unsigned char c = (unsigned char)vm_bytes_byte(tp,vm_operations_get(tp,tp->params,vm_none));
+    vm_bytes_write(tp,self,&c,1);
+    return vm_none;
+}
+
+type_vmObj vm_bytes_extend(type_vm *tp) {
+    type_vmBytes *self = vm_bytes_self(tp);
+    vm_bytes_extend_sub(tp,self,vm_operations_get(tp,tp->params,vm_none));
+    return vm_none;
+}
+
+/* b.string() copies the bytes into a string. */
+type_vmObj vm_bytes_string(type_vm *tp) {
+    type_vmBytes *self = vm_bytes_self(tp);
+    if (!self->len) { return vm_string(""); }
+    return vm_string_copy(tp,(char const*)vm_bytes_ptr(self),self->len);
+}
+
+type_vmObj vm_bytes_get(type_vm *tp, type_vmObj self, type_vmObj k) {
+    type_vmBytes *b = vm_bytes_of(self);
+    if (k.type == vm_enum1_number) {
+        return vm_create_numericObj(vm_bytes_ptr(b)[vm_bytes_index(tp,b,k,1)]);
+    } else if (k.type == vm_enum1_list) {
+        type_vmObj x = vm_operations_get(tp,k,vm_create_numericObj(0));
+        type_vmObj y = vm_operations_get(tp,k,vm_create_numericObj(1));
+        int l = b->len;
+        int a = x.type == vm_enum1_none ? 0 : vm_typecheck(tp,vm_enum1_number,x).number.val;
+        int e = y.type == vm_enum1_none ? l : vm_typecheck(tp,vm_enum1_number,y).number.val;
+        a = vm_max(0,(a<0?l+a:a)); e = vm_min(l,(e<0?l+e:e));
+        return vm_bytes_view(tp,b->buf,b->off+a,vm_max(0,e-a));
+    } else if (k.type == vm_enum1_string) {
+        if (vm_operations_cmp(tp,vm_string("pack"),k) == 0) {
+            return vm_misc_method(tp,self,vm_bytes_pack);
+        } else if (vm_operations_cmp(tp,vm_string("unpack"),k) == 0) {
+            return vm_misc_method(tp,self,vm_bytes_unpack);
+        } else if (vm_operations_cmp(tp,vm_string("append"),k) == 0) {
+            return vm_misc_method(tp,self,vm_bytes_append);
+        } else if (vm_operations_cmp(tp,vm_string("extend"),k) == 0) {
+            return vm_misc_method(tp,self,vm_bytes_extend);
+        } else if (vm_operations_cmp(tp,vm_string("string"),k) == 0) {
+            return vm_misc_method(tp,self,vm_bytes_string);
+        }
+    }
+    vm_raise(tp,vm_string("(vm_bytes_get) KeyError"));
+    return vm_none;
+}
+
+void vm_bytes_set(type_vm *tp, type_vmObj self, type_vmObj k, type_vmObj v) {
+    type_vmBytes *b = vm_bytes_of(self);
+    if (k.type == vm_enum1_none) {
+        unsigned char c = (unsigned char)vm_bytes_byte(tp,v);
+        vm_bytes_write(tp,b,&c,1);
+        return;
+    }
+    vm_bytes_ptr(b)[vm_bytes_index(tp,b,k,1)] = (unsigned char)vm_bytes_byte(tp,v);
+}
+
+type_vmObj vm_bytes_len(type_vm *tp, type_vmObj self) {
+    return vm_create_numericObj(vm_bytes_of(self)->len);
+}
+
+type_vmObj vm_bytes_str(type_vm *tp, type_vmObj self) {
+    return vm_string_printf(tp,"<bytearray %d>",vm_bytes_of(self)->len);
+}
+
+void vm_bytes_free(type_vm *tp, type_vmObj self) {
+    type_vmBytes *b = vm_bytes_of(self);
+    if (--b->buf->refs == 0) {
+        free(b->buf->s);
+        free(b->buf);
+    }
+    free(b);
+}
+
+/* Function: vm_bytes_view
+ * A bytearray for buf[off..off+len), sharing buf.
+ */
+type_vmObj vm_bytes_view(type_vm *tp, type_vmBuffer *buf, int off, int len) {
+    type_vmBytes *b = (type_vmBytes*)calloc(sizeof(type_vmBytes),1);/*calloc((x),1)*/
+    type_vmObj r;
+    buf->refs += 1;
+    b->buf = buf;
+    b->off = off;
+    b->len = len;
+    r = vm_misc_dataObj(tp,vm_enum3_bytes,b);
+    r.data.info->free = vm_bytes_free;
+    r.data.info->get = vm_bytes_get;
+    r.data.info->set = vm_bytes_set;
+    r.data.info->len = vm_bytes_len;
+    r.data.info->str = vm_bytes_str;
+    return r;
+}
+
+/* Function: vm_bytes_new
+ * bytearray(x) makes a new bytearray.
+ *
+ * x is a number of zero bytes, or a string, bytearray or list of numbers
+ * whose bytes are copied. Without x the bytearray is empty.
+ */
+type_vmObj vm_bytes_new(type_vm *tp) {
+    type_vmObj v = vm_macros_DEFAULT(vm_create_numericObj(0));
+    type_vmBuffer *buf = (type_vmBuffer*)calloc(sizeof(type_vmBuffer),1);/*calloc((x),1)*/
+    type_vmObj r = vm_bytes_view(tp,buf,0,0);
+    if (v.type == vm_enum1_number) {
+        int n = vm_max(0,(int)v.number.val);
+        vm_bytes_reserve(tp,vm_bytes_of(r),n);
+        if (n) { memset(buf->s,0,n); }
+        buf->len = n;
+        vm_bytes_of(r)->len = n;
+    } else {
+        vm_bytes_extend_sub(tp,vm_bytes_of(r),v);
+    }
+    return r;
+}
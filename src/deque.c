@@ -0,0 +1,177 @@
+/* File: Deque
+ * Double ended queues returned by deque().
+ *
+ * Items live in a ring buffer whose size is a power of two, so adding or
+ * removing at either end is O(1) amortized.
+ */
+
+typedef struct type_vmDeque {
+    type_vmObj *items;
+    int head;
+    int len;
+    int alloc;
+} type_vmDeque;
+
+vm_inline static type_vmDeque *vm_deque_of(type_vmObj self) {
+    return (type_vmDeque*)self.data.val;
+}
+
+vm_inline static type_vmDeque *vm_deque_self(type_vm *tp) {
+    return vm_deque_of(vm_operations_get(tp,tp->params,vm_none));
+}
+
+/* Slot of item n. */
+vm_inline static type_vmObj *vm_deque_at(type_vmDeque *self, int n) {
+    return &self->items[(self->head+n)&(self->alloc-1)];
+}
+
+static void vm_deque_grow(type_vmDeque *self) {
+    int alloc = self->alloc ? self->alloc*2 : 8, n;
+    type_vmObj *items = (type_vmObj*)malloc(alloc*sizeof(type_vmObj));/*malloc(x)*/
+    for (n=0; n<self->len; n++) { items[n] = *vm_deque_at(self,n); }
+    free(self->items);
+    self->items = items;
+    self->head = 0;
+    self->alloc = alloc;
+}
+
+static int vm_deque_index(type_vm *tp, type_vmDeque *self, type_vmObj k) {
+    int n = vm_typecheck(tp,vm_enum1_number,k).number.val;
+    n = n < 0 ? self->len+n : n;
+    if (n < 0 || n >= self->len) {
+        vm_raise(tp,vm_string("(vm_deque_index) IndexError: deque index out of range"));
+    }
+    return n;
+}
+
+void vm_deque_push(type_vm *tp, type_vmDeque *self, type_vmObj v, int left) {
+    if (self->len == self->alloc) { vm_deque_grow(self); }
+    if (left) {
+        self->head = (self->head-1)&(self->alloc-1);
+        self->items[self->head] = v;
+    } else {
+        *vm_deque_at(self,self->len) = v;
+    }
+    self->len += 1;
+    vm_gc_grey(tp,v);
+}
+
+type_vmObj vm_deque_shift(type_vm *tp, type_vmDeque *self, int left) {
+    type_vmObj r;
+    if (!self->len) {
+        vm_raise(tp,vm_string("(vm_deque_shift) IndexError: pop from an empty deque"));
+    }
+    if (left) {
+        r = self->items[self->head];
+        self->head = (self->head+1)&(self->alloc-1);
+    } else {
+        r = *vm_deque_at(self,self->len-1);
+    }
+    self->len -= 1;
+    return r;
+}
+
+type_vmObj vm_deque_append(type_vm *tp) {
+    type_vmDeque *self = vm_deque_self(tp);
+    vm_deque_push(tp,self,vm_operations_get(tp,tp->params,vm_none),0);
+    return vm_none;
+}
+type_vmObj vm_deque_appendleft(type_vm *tp) {
+    type_vmDeque *self = vm_deque_self(tp);
+    vm_deque_push(tp,self,vm_operations_get(tp,tp->params,vm_none),1);
+    return vm_none;
+}
+type_vmObj vm_deque_pop(type_vm *tp) {
+    return vm_deque_shift(tp,vm_deque_self(tp),0);
+}
+type_vmObj vm_deque_popleft(type_vm *tp) {
+    return vm_deque_shift(tp,vm_deque_self(tp),1);
+}
+
+type_vmObj vm_deque_extend(type_vm *tp) {
+    type_vmDeque *self = vm_deque_self(tp);
+    type_vmObj v = vm_typecheck(tp,vm_enum1_list,vm_operations_get(tp,tp->params,vm_none));
+    int i;
+    for (i=0; i<v.list.val->len; i++) { vm_deque_push(tp,self,vm_list_at(v.list.val,i),0); }
+    return vm_none;
+}
+
+type_vmObj vm_deque_clear(type_vm *tp) {
+    type_vmDeque *self = vm_deque_self(tp);
+    self->head = 0;
+    self->len = 0;
+    return vm_none;
+}
+
+type_vmObj vm_deque_get(type_vm *tp, type_vmObj self, type_vmObj k) {
+    type_vmDeque *d = vm_deque_of(self);
+    if (k.type == vm_enum1_number) {
+        return *vm_deque_at(d,vm_deque_index(tp,d,k));
+    } else if (k.type == vm_enum1_string) {
+        if (vm_operations_cmp(tp,vm_string("append"),k) == 0) {
+            return vm_misc_method(tp,self,vm_deque_append);
+        } else if (vm_operations_cmp(tp,vm_string("appendleft"),k) == 0) {
+            return vm_misc_method(tp,self,vm_deque_appendleft);
+        } else if (vm_operations_cmp(tp,vm_string("pop"),k) == 0) {
+            return vm_misc_method(tp,self,vm_deque_pop);
+        } else if (vm_operations_cmp(tp,vm_string("popleft"),k) == 0) {
+            return vm_misc_method(tp,self,vm_deque_popleft);
+        } else if (vm_operations_cmp(tp,vm_string("extend"),k) == 0) {
+            return vm_misc_method(tp,self,vm_deque_extend);
+        } else if (vm_operations_cmp(tp,vm_string("clear"),k) == 0) {
+            return vm_misc_method(tp,self,vm_deque_clear);
+        }
+    }
+    vm_raise(tp,vm_string("(vm_deque_get) KeyError"));
+    return vm_none;
+}
+
+void vm_deque_set(type_vm *tp, type_vmObj self, type_vmObj k, type_vmObj v) {
+    type_vmDeque *d = vm_deque_of(self);
+    if (k.type == vm_enum1_none) {
+        vm_deque_push(tp,d,v,0);
+        return;
+    }
+    *vm_deque_at(d,vm_deque_index(tp,d,k)) = v;
+    vm_gc_grey(tp,v);
+}
+
+type_vmObj vm_deque_len(type_vm *tp, type_vmObj self) {
+    return vm_create_numericObj(vm_deque_of(self)->len);
+}
+
+type_vmObj vm_deque_str(type_vm *tp, type_vmObj self) {
+    return vm_string_printf(tp,"<deque %d>",vm_deque_of(self)->len);
+}
+
+void vm_deque_follow(type_vm *tp, type_vmObj self) {
+    type_vmDeque *d = vm_deque_of(self);
+    int n;
+    for (n=0; n<d->len; n++) { vm_gc_grey(tp,*vm_deque_at(d,n)); }
+}
+
+void vm_deque_free(type_vm *tp, type_vmObj self) {
+    free(vm_deque_of(self)->items);
+    free(vm_deque_of(self));
+}
+
+/* Function: vm_deque_new
+ * deque([list]) makes a new deque, holding the items of list if given.
+ */
+type_vmObj vm_deque_new(type_vm *tp) {
+    type_vmObj v = vm_macros_DEFAULT(vm_none);
+    type_vmDeque *d = (type_vmDeque*)calloc(sizeof(type_vmDeque),1);/*calloc((x),1)*/
+    type_vmObj r = vm_misc_dataObj(tp,vm_enum3_deque,d);
+    int i;
+    r.data.info->free = vm_deque_free;
+    r.data.info->get = vm_deque_get;
+    r.data.info->set = vm_deque_set;
+    r.data.info->len = vm_deque_len;
+    r.data.info->str = vm_deque_str;
+    r.data.info->follow = vm_deque_follow;
+    if (v.type != vm_enum1_none) {
+        vm_typecheck(tp,vm_enum1_list,v);
+        for (i=0; i<v.list.val->len; i++) { vm_deque_push(tp,d,vm_list_at(v.list.val,i),0); }
+    }
+    return r;
+}
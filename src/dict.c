@@ -1,82 +1,288 @@
 /* File: Dict
  * Functions for dealing with dictionaries.
  */
-int vm_dict_lua_hash(void const *v,int l) {
-    int i,step = (l>>5)+1;
-    int h = l + (l >= 4?*(int*)v:0);
-    for (i=l; i>=step; i-=step) {
-        h = h^((h<<5)+(h>>2)+((unsigned char *)v)[i-1]);
+/* Function: vm_dict_hash_bytes
+ * Seeded hash of a block of memory.
+ *
+ * An xxHash32 style hash: every byte of v is mixed in, four 32 bit lanes
+ * at a time for long keys, then the result is avalanched. The seed comes
+ * from <type_vm>.hash_seed so colliding key sets cannot be precomputed.
+ */
+#define vm_def_HASH_P1 2654435761U
+#define vm_def_HASH_P2 2246822519U
+#define vm_def_HASH_P3 3266489917U
+#define vm_def_HASH_P4 668265263U
+#define vm_def_HASH_P5 374761393U
+
+vm_inline static unsigned int vm_dict_rotl(unsigned int x, int r) {
+    return (x<<r)|(x>>(32-r));
+}
+vm_inline static unsigned int vm_dict_read32(unsigned char const *p) {
+    unsigned int r; memcpy(&r,p,4); return r;
+}
+vm_inline static unsigned int vm_dict_round(unsigned int acc, unsigned int in) {
+    return vm_dict_rotl(acc+in*vm_def_HASH_P2,13)*vm_def_HASH_P1;
+}
+
+int vm_dict_hash_bytes(unsigned int seed, void const *v, int l) {
+    unsigned char const *p = (unsigned char const *)v;
+    unsigned char const *e = p+l;
+    unsigned int h;
+    if (l >= 16) {
+        unsigned int v1 = seed+vm_def_HASH_P1+vm_def_HASH_P2;
+        unsigned int v2 = seed+vm_def_HASH_P2;
+        unsigned int v3 = seed;
+        unsigned int v4 = seed-vm_def_HASH_P1;
+        do {
+            v1 = vm_dict_round(v1,vm_dict_read32(p));
+            v2 = vm_dict_round(v2,vm_dict_read32(p+4));
+            v3 = vm_dict_round(v3,vm_dict_read32(p+8));
+            v4 = vm_dict_round(v4,vm_dict_read32(p+12));
+            p += 16;
+        } while (p <= e-16);
+        h = vm_dict_rotl(v1,1)+vm_dict_rotl(v2,7)+vm_dict_rotl(v3,12)+vm_dict_rotl(v4,18);
+    } else {
+        h = seed+vm_def_HASH_P5;
+    }
+    h += (unsigned int)l;
+    for (; p+4 <= e; p += 4) {
+        h = vm_dict_rotl(h+vm_dict_read32(p)*vm_def_HASH_P3,17)*vm_def_HASH_P4;
     }
-    return h;
+    for (; p < e; p++) {
+        h = vm_dict_rotl(h+(*p)*vm_def_HASH_P5,11)*vm_def_HASH_P1;
+    }
+    h ^= h>>15; h *= vm_def_HASH_P2;
+    h ^= h>>13; h *= vm_def_HASH_P3;
+    h ^= h>>16;
+    return (int)h;
+}
+
+/* Function: vm_dict_seed
+ * Picks a per-VM hash seed from the clock and the VM's address.
+ */
+unsigned int vm_dict_seed(type_vm *tp) {
+    struct { time_t t; clock_t c; void *p; } s;
+    memset(&s,0,sizeof(s));
+    s.t = time(0); s.c = clock(); s.p = tp;
+    return (unsigned int)vm_dict_hash_bytes(vm_def_HASH_P5,&s,sizeof(s));
 }
 void vm_dict_free(type_vm *tp, type_vmDict *self) {
     free(self->items);
+    free(self->index);
+    free(self->mcache);
     free(self);
 }
 
+/* Control bytes, one per index slot. A full slot stores the low 7 bits of
+ * its hash (vm_dict_h2), so a probe can reject most candidates without
+ * touching the entries.
+ */
+#define vm_def_DICT_EMPTY 0x80
+#define vm_def_DICT_DELETED 0xfe
+
+/* Slots are probed a group at a time, see <vm_dict_group_match>. */
+#ifdef __AVX2__
+#define vm_def_DICT_GROUP 32
+#else
+#define vm_def_DICT_GROUP 16
+#endif
+
+vm_inline static unsigned int vm_dict_h1(int hash) { return ((unsigned int)hash)>>7; }
+vm_inline static unsigned char vm_dict_h2(int hash) { return hash&0x7f; }
+
+/* Function: vm_dict_ixwidth
+ * Size in bytes of one index slot for a table with alloc entries.
+ */
+vm_inline static int vm_dict_ixwidth(int alloc) {
+    if (alloc <= 0xff) { return 1; }
+    if (alloc <= 0xffff) { return 2; }
+    return 4;
+}
+
+/* The index block is mask+1 control bytes followed by mask+1 slots. */
+vm_inline static unsigned char *vm_dict_ctrl(type_vmDict *self) {
+    return (unsigned char*)self->index;
+}
+
+vm_inline static int vm_dict_ixget(type_vmDict *self, int i) {
+    void *ix = vm_dict_ctrl(self)+self->mask+1;
+    switch (vm_dict_ixwidth(self->alloc)) {
+        case 1: return ((unsigned char*)ix)[i];
+        case 2: return ((unsigned short*)ix)[i];
+    }
+    return ((unsigned int*)ix)[i];
+}
+
+vm_inline static void vm_dict_ixset(type_vmDict *self, int i, int n) {
+    void *ix = vm_dict_ctrl(self)+self->mask+1;
+    switch (vm_dict_ixwidth(self->alloc)) {
+        case 1: ((unsigned char*)ix)[i] = n; return;
+        case 2: ((unsigned short*)ix)[i] = n; return;
+    }
+    ((unsigned int*)ix)[i] = n;
+}
+
+/* Function: vm_dict_group_match
+ * Bitmask of the control bytes in a group equal to c.
+ *
+ * Bit i is set when g[i] == c. Uses one compare over the whole group with
+ * AVX2 or SSE2, and a plain loop elsewhere.
+ */
+vm_inline static unsigned int vm_dict_group_match(unsigned char const *g, unsigned char c) {
+#if defined(__AVX2__)
+    __m256i v = _mm256_loadu_si256((__m256i const*)g);
+    return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v,_mm256_set1_epi8((char)c)));
+#elif defined(__SSE2__)
+    __m128i v = _mm_loadu_si128((__m128i const*)g);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v,_mm_set1_epi8((char)c)));
+#else
+    unsigned int r = 0; int i;
+    for (i=0; i<vm_def_DICT_GROUP; i++) { r |= (unsigned int)(g[i] == c)<<i; }
+    return r;
+#endif
+}
+
+/* Bitmask of the empty or deleted slots in a group (high bit set). */
+vm_inline static unsigned int vm_dict_group_free(unsigned char const *g) {
+#if defined(__AVX2__)
+    return (unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((__m256i const*)g));
+#elif defined(__SSE2__)
+    return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((__m128i const*)g));
+#else
+    unsigned int r = 0; int i;
+    for (i=0; i<vm_def_DICT_GROUP; i++) { r |= (unsigned int)(g[i]>>7)<<i; }
+    return r;
+#endif
+}
 
 int vm_dict_hash(type_vm *tp,type_vmObj v) {
+    unsigned int seed = tp ? tp->hash_seed : 0;
     switch (v.type) {
         case vm_enum1_none: return 0;
-        case vm_enum1_number: return vm_dict_lua_hash(&v.number.val,sizeof(type_vmNum));
-        case vm_enum1_string: return vm_dict_lua_hash(v.string.val,v.string.len);
-        case vm_enum1_dict: return vm_dict_lua_hash(&v.dict.val,sizeof(void*));
+        case vm_enum1_number: {
+            /* 0.0 == -0.0, so they must hash alike */
+            type_vmNum n = v.number.val == 0 ? 0 : v.number.val;
+            return vm_dict_hash_bytes(seed,&n,sizeof(type_vmNum));
+        }
+        case vm_enum1_string: return vm_dict_hash_bytes(seed,v.string.val,v.string.len);
+        case vm_enum1_dict: return vm_dict_hash_bytes(seed,&v.dict.val,sizeof(void*));
         case vm_enum1_list: {
-            int r = v.list.val->len; int n; for(n=0; n<v.list.val->len; n++) {
-            type_vmObj vv = v.list.val->items[n]; r += vv.type != vm_enum1_list?vm_dict_hash(tp,v.list.val->items[n]):vm_dict_lua_hash(&vv.list.val,sizeof(void*)); } return r;
+            unsigned int r = seed+vm_def_HASH_P5+v.list.val->len; int n;
+            for (n=0; n<v.list.val->len; n++) {
+                type_vmObj vv = vm_list_at(v.list.val,n);
+                unsigned int h = vv.type != vm_enum1_list?vm_dict_hash(tp,vv):vm_dict_hash_bytes(seed,&vv.list.val,sizeof(void*));
+                r = vm_dict_round(r,h);
+            }
+            return (int)r;
         }
-        case vm_enum1_fnc: return vm_dict_lua_hash(&v.fnc.info,sizeof(void*));
-        case vm_enum1_data: return vm_dict_lua_hash(&v.data.val,sizeof(void*));
+        case vm_enum1_fnc: return vm_dict_hash_bytes(seed,&v.fnc.info,sizeof(void*));
+        case vm_enum1_data: return vm_dict_hash_bytes(seed,&v.data.val,sizeof(void*));
     }
     vm_raise(0,vm_string("(vm_dict_hash) TypeError: value unhashable"));
 	return 0;
 }
 
+/* Claims the first free index slot along hash's probe sequence for entry n.
+ * Groups are visited with triangular steps, which covers every group since
+ * the group count is a power of two.
+ */
+void vm_dict_ixinsert_sub(type_vmDict *self, int hash, int n) {
+    unsigned char *ctrl = vm_dict_ctrl(self);
+    int pos = vm_dict_h1(hash)&self->mask&~(vm_def_DICT_GROUP-1);
+    int step = 0;
+    while (1) {
+        unsigned int m = vm_dict_group_free(ctrl+pos);
+        if (m) {
+            int i = pos+__builtin_ctz(m);
+            ctrl[i] = vm_dict_h2(hash);
+            vm_dict_ixset(self,i,n);
+            return;
+        }
+        step += vm_def_DICT_GROUP;
+        pos = (pos+step)&self->mask;
+    }
+}
+
+/* Rebuilds the index from the (hole free) entries. */
+void vm_dict_reindex_sub(type_vmDict *self) {
+    int n;
+    memset(vm_dict_ctrl(self),vm_def_DICT_EMPTY,self->mask+1);
+    for (n=0; n<self->used; n++) {
+        vm_dict_ixinsert_sub(self,self->items[n].hash,n);
+    }
+}
+
 void vm_dict_hash_set_sub(type_vm *tp,type_vmDict *self, int hash, type_vmObj k, type_vmObj v) {
     type_vmItem item;
-    int i,idx = hash&self->mask;
-    for (i=idx; i<idx+self->alloc; i++) {
-        int n = i&self->mask;
-        if (self->items[n].used > 0) { continue; }
-        if (self->items[n].used == 0) { self->used += 1; }
-        item.used = 1;
-        item.hash = hash;
-        item.key = k;
-        item.val = v;
-        self->items[n] = item;
-        self->len += 1;
-        return;
-    }
-    vm_raise(tp,vm_string("(vm_dict_hash_set_sub) RuntimeError: ?"));
+    int n = self->used;
+    if (n >= self->alloc) {
+        vm_raise(tp,vm_string("(vm_dict_hash_set_sub) RuntimeError: ?"));
+    }
+    item.used = 1;
+    item.hash = hash;
+    item.key = k;
+    item.val = v;
+    self->items[n] = item;
+    self->used += 1;
+    self->len += 1;
+    vm_dict_ixinsert_sub(self,hash,n);
+    if (self->shape) {
+        self->shape = (self->shape->len == n ? vm_shape_add(self->shape,hash,k) : 0);
+    }
 }
 
+/* Resizes the table to hold at least len entries, dropping holes. */
 void vm_dict_realloc_sub(type_vm *tp,type_vmDict *self,int len) {
     type_vmItem *items = self->items;
-    int i,alloc = self->alloc;
-    len = vm_max(8,len);
+    int i,n,used = self->used;
+    int slots = vm_def_DICT_GROUP;
+    while ((slots*2)/3 < len) { slots *= 2; }
 
-    self->items = (type_vmItem*)calloc(len*sizeof(type_vmItem),1);/*calloc((x),1)*/
-    self->alloc = len; self->mask = len-1;
-    self->len = 0; self->used = 0;
+    free(self->index);
+    self->alloc = (slots*2)/3; self->mask = slots-1;
+    self->items = (type_vmItem*)calloc(self->alloc*sizeof(type_vmItem),1);/*calloc((x),1)*/
+    self->index = malloc(slots*(1+vm_dict_ixwidth(self->alloc)));
 
-    for (i=0; i<alloc; i++) {
-        if (items[i].used != 1) { continue; }
-        vm_dict_hash_set_sub(tp,self,items[i].hash,items[i].key,items[i].val);
+    for (i=0,n=0; i<used; i++) {
+        if (items[i].used) { self->items[n++] = items[i]; }
     }
+    self->used = self->len = n;
+    self->atk = -1;
+    vm_dict_reindex_sub(self);
     free(items);
 }
 
-int vm_dict_hash_find_sub(type_vm *tp,type_vmDict *self, int hash, type_vmObj k) {
-    int i,idx = hash&self->mask;
-    for (i=idx; i<idx+self->alloc; i++) {
-        int n = i&self->mask;
-        if (self->items[n].used == 0) { break; }
-        if (self->items[n].used < 0) { continue; }
-        if (self->items[n].hash != hash) { continue; }
-        if (vm_operations_cmp(tp,self->items[n].key,k) != 0) { continue; }
-        return n;
+/* Returns the entry holding k, or -1. The index slot is stored in *slot.
+ * Only slots whose control byte matches the hash's 7 bit tag are compared,
+ * and the probe stops at the first group that still has an empty slot.
+ */
+int vm_dict_lookup_sub(type_vm *tp,type_vmDict *self, int hash, type_vmObj k, int *slot) {
+    unsigned char *ctrl;
+    unsigned char h2 = vm_dict_h2(hash);
+    int pos,step = 0;
+    if (!self->index) { return -1; }
+    ctrl = vm_dict_ctrl(self);
+    pos = vm_dict_h1(hash)&self->mask&~(vm_def_DICT_GROUP-1);
+    while (1) {
+        unsigned int m = vm_dict_group_match(ctrl+pos,h2);
+        while (m) {
+            int i = pos+__builtin_ctz(m);
+            int n = vm_dict_ixget(self,i);
+            if (self->items[n].hash == hash && vm_operations_cmp(tp,self->items[n].key,k) == 0) {
+                *slot = i;
+                return n;
+            }
+            m &= m-1;
+        }
+        if (vm_dict_group_match(ctrl+pos,vm_def_DICT_EMPTY)) { return -1; }
+        step += vm_def_DICT_GROUP;
+        pos = (pos+step)&self->mask;
     }
-    return -1;
+}
+
+int vm_dict_hash_find_sub(type_vm *tp,type_vmDict *self, int hash, type_vmObj k) {
+    int slot;
+    return vm_dict_lookup_sub(tp,self,hash,k,&slot);
 }
 int vm_dict_find_sub(type_vm *tp,type_vmDict *self,type_vmObj k) {
     return vm_dict_hash_find_sub(tp,self,vm_dict_hash(tp,k),k);
@@ -84,11 +290,10 @@ int vm_dict_find_sub(type_vm *tp,type_vmDict *self,type_vmObj k) {
 
 void vm_dict_setx_sub(type_vm *tp,type_vmDict *self,type_vmObj k, type_vmObj v) {
     int hash = vm_dict_hash(tp,k); int n = vm_dict_hash_find_sub(tp,self,hash,k);
+    if (self->ismeta) { tp->meta_epoch += 1; }
     if (n == -1) {
-        if (self->len >= (self->alloc/2)) {
-            vm_dict_realloc_sub(tp,self,self->alloc*2);
-        } else if (self->used >= (self->alloc*3/4)) {
-            vm_dict_realloc_sub(tp,self,self->alloc);
+        if (self->used >= self->alloc) {
+            vm_dict_realloc_sub(tp,self,self->len*2+1);
         }
         vm_dict_hash_set_sub(tp,self,hash,k,v);
     } else {
@@ -109,26 +314,44 @@ type_vmObj vm_dict_get(type_vm *tp,type_vmDict *self,type_vmObj k, const char *e
     return self->items[n].val;
 }
 
+/* Removes entry n, found at index slot by <vm_dict_lookup_sub>. */
+void vm_dict_remove_sub(type_vm *tp,type_vmDict *self,int slot,int n) {
+    vm_dict_ctrl(self)[slot] = vm_def_DICT_DELETED;
+    self->items[n].used = 0;
+    self->items[n].key = vm_none;
+    self->items[n].val = vm_none;
+    self->len -= 1;
+    self->shape = 0;
+    self->atk = -1;
+    if (self->ismeta) { tp->meta_epoch += 1; }
+}
+
 void vm_dict_del(type_vm *tp,type_vmDict *self,type_vmObj k, const char *error) {
-    int n = vm_dict_find_sub(tp,self,k);
+    int slot;
+    int n = vm_dict_lookup_sub(tp,self,vm_dict_hash(tp,k),k,&slot);
     if (n < 0) {
         vm_raise(tp,vm_operations_add(tp,vm_string("(vm_dict_del) KeyError: "),vm_operations_str(tp,k)));
     }
-    self->items[n].used = -1;
-    self->len -= 1;
+    vm_dict_remove_sub(tp,self,slot,n);
 }
 
 type_vmDict *vm_dict_new(type_vm *tp) {
     type_vmDict *self = (type_vmDict*)calloc(sizeof(type_vmDict),1);/*calloc((x),1)*/
+    self->atk = -1;
     return self;
 }
 type_vmObj vm_dict_copy(type_vm *tp,type_vmObj rr) {
     type_vmObj obj = {vm_enum1_dict};
     type_vmDict *o = rr.dict.val;
     type_vmDict *r = vm_dict_new(tp);
-    *r = *o; r->gci = 0;
+    *r = *o; r->gci = 0; r->ismeta = 0; r->mcache = 0;
     r->items = (type_vmItem*)calloc(sizeof(type_vmItem)*o->alloc,1);/*calloc((x),1)*/
-    memcpy(r->items,o->items,sizeof(type_vmItem)*o->alloc);
+    memcpy(r->items,o->items,sizeof(type_vmItem)*o->used);
+    if (o->index) {
+        int l = (o->mask+1)*(1+vm_dict_ixwidth(o->alloc));
+        r->index = malloc(l);
+        memcpy(r->index,o->index,l);
+    }
     obj.dict.val = r;
     obj.dict.dtype = 1;
     return vm_gc_track(tp,obj);
@@ -139,7 +362,7 @@ int vm_dict_next(type_vm *tp,type_vmDict *self) {
         vm_raise(0,vm_string("(vm_dict_next) RuntimeError"));
     }
     while (1) {
-        self->curFrame = ((self->curFrame + 1) & self->mask);
+        self->curFrame = (self->curFrame + 1 < self->used ? self->curFrame + 1 : 0);
         if (self->items[self->curFrame].used > 0) {
             return self->curFrame;
         }
@@ -147,14 +370,155 @@ int vm_dict_next(type_vm *tp,type_vmDict *self) {
 
 }
 
+/* Function: vm_dict_at
+ * Returns the entry number of the k-th key in insertion order.
+ *
+ * Holes left by deleted keys are stepped over rather than squeezed out, so
+ * entries never move under a loop. Asking for the keys in order resumes
+ * from the last answer, which keeps that walk linear.
+ */
+int vm_dict_at(type_vm *tp,type_vmDict *self,int k) {
+    int i = -1, n = 0;
+    if (k < 0 || k >= self->len) {
+        vm_raise(tp,vm_string("(vm_dict_at) RuntimeError: index out of range"));
+    }
+    if (self->used == self->len) { return k; }
+    if (self->atk >= 0 && k > self->atk) { i = self->atk; n = self->atn+1; }
+    for (;; n++) {
+        if (self->items[n].used && ++i == k) { break; }
+    }
+    self->atk = k;
+    self->atn = n;
+    return n;
+}
+
+/* Function: vm_dict_iter
+ * Returns the first entry at or after entry n that holds a key, or -1.
+ *
+ * Loops over a dict step through entry numbers with this, so deleting keys
+ * in the loop body neither skips nor repeats any other key.
+ */
+int vm_dict_iter(type_vmDict *self,int n) {
+    for (; n < self->used; n++) {
+        if (self->items[n].used) { return n; }
+    }
+    return -1;
+}
+
+/* Function: vm_dict_update_sub
+ * Sets every entry of o in self.
+ *
+ * The table is resized at most once, up front, and the hashes stored in o
+ * are reused, so no key is hashed again.
+ */
+void vm_dict_update_sub(type_vm *tp,type_vmDict *self,type_vmDict *o) {
+    int i, n, len = o->len;
+    if (self->used+len > self->alloc) {
+        vm_dict_realloc_sub(tp,self,self->len+len);
+    }
+    for (i=0; i<o->used && len; i++) {
+        type_vmItem *e = &o->items[i];
+        if (!e->used) { continue; }
+        n = vm_dict_hash_find_sub(tp,self,e->hash,e->key);
+        if (n < 0) { vm_dict_hash_set_sub(tp,self,e->hash,e->key,e->val); }
+        else { self->items[n].val = e->val; }
+        vm_gc_grey(tp,e->key); vm_gc_grey(tp,e->val);
+        len -= 1;
+    }
+    if (self->ismeta) { tp->meta_epoch += 1; }
+}
+
 type_vmObj vm_dict_merge(type_vm *tp) {
     type_vmObj self = vm_operations_get(tp,tp->params,vm_none);
     type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
-    int i; for (i=0; i<v.dict.val->len; i++) {
-        int n = vm_dict_next(tp,v.dict.val);
-        vm_dict_set_sub(tp,self.dict.val,
-            v.dict.val->items[n].key,v.dict.val->items[n].val);
+    vm_dict_update_sub(tp,self.dict.val,v.dict.val);
+    return vm_none;
+}
+
+/* A list of the keys (0), values (1) or [key,value] pairs (2) of self. */
+static type_vmObj vm_dict_list(type_vm *tp,type_vmDict *self,int what) {
+    type_vmObj r = vm_list(tp);
+    int n;
+    vm_list_realloc(tp,r.list.val,self->len);
+    for (n=0; n<self->used; n++) {
+        type_vmItem *e = &self->items[n];
+        if (!e->used) { continue; }
+        if (what == 0) { vm_list_append(tp,r.list.val,e->key); }
+        else if (what == 1) { vm_list_append(tp,r.list.val,e->val); }
+        else {
+            type_vmObj kv[2];
+            kv[0] = e->key; kv[1] = e->val;
+            vm_list_append(tp,r.list.val,vm_list_n(tp,2,kv));
+        }
+    }
+    return r;
+}
+
+type_vmObj vm_dict_keys(type_vm *tp) {
+    return vm_dict_list(tp,vm_operations_get(tp,tp->params,vm_none).dict.val,0);
+}
+type_vmObj vm_dict_values(type_vm *tp) {
+    return vm_dict_list(tp,vm_operations_get(tp,tp->params,vm_none).dict.val,1);
+}
+type_vmObj vm_dict_items(type_vm *tp) {
+    return vm_dict_list(tp,vm_operations_get(tp,tp->params,vm_none).dict.val,2);
+}
+
+/* Function: vm_dict_get2
+ * d.get(k,default=None) is d[k], or default when k is missing.
+ */
+type_vmObj vm_dict_get2(type_vm *tp) {
+    type_vmDict *self = vm_operations_get(tp,tp->params,vm_none).dict.val;
+    type_vmObj k = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj d = vm_macros_DEFAULT(vm_none);
+    int n = vm_dict_find_sub(tp,self,k);
+    return n < 0 ? d : self->items[n].val;
+}
+
+/* Function: vm_dict_setdefault
+ * d.setdefault(k,default=None) is d[k], setting it to default first when
+ * k is missing.
+ */
+type_vmObj vm_dict_setdefault(type_vm *tp) {
+    type_vmDict *self = vm_operations_get(tp,tp->params,vm_none).dict.val;
+    type_vmObj k = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj d = vm_macros_DEFAULT(vm_none);
+    int hash = vm_dict_hash(tp,k);
+    int n = vm_dict_hash_find_sub(tp,self,hash,k);
+    if (n >= 0) { return self->items[n].val; }
+    if (self->ismeta) { tp->meta_epoch += 1; }
+    if (self->used >= self->alloc) { vm_dict_realloc_sub(tp,self,self->len*2+1); }
+    vm_dict_hash_set_sub(tp,self,hash,k,d);
+    vm_gc_grey(tp,k); vm_gc_grey(tp,d);
+    return d;
+}
+
+/* Function: vm_dict_pop
+ * d.pop(k[,default]) removes d[k] and returns it. When k is missing it
+ * returns default, or raises KeyError if there is none.
+ */
+type_vmObj vm_dict_pop(type_vm *tp) {
+    type_vmDict *self = vm_operations_get(tp,tp->params,vm_none).dict.val;
+    type_vmObj k = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj r;
+    int slot;
+    int n = vm_dict_lookup_sub(tp,self,vm_dict_hash(tp,k),k,&slot);
+    if (n < 0 && tp->params.list.val->len) { return vm_operations_get(tp,tp->params,vm_none); }
+    if (n < 0) {
+        vm_raise(tp,vm_operations_add(tp,vm_string("(vm_dict_pop) KeyError: "),vm_operations_str(tp,k)));
     }
+    r = self->items[n].val;
+    vm_dict_remove_sub(tp,self,slot,n);
+    return r;
+}
+
+/* Function: vm_dict_update
+ * d.update(o) sets every entry of the dict o in d, see <vm_dict_update_sub>.
+ */
+type_vmObj vm_dict_update(type_vm *tp) {
+    type_vmObj self = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj o = vm_typecheck(tp,vm_enum1_dict,vm_operations_get(tp,tp->params,vm_none));
+    vm_dict_update_sub(tp,self.dict.val,o.dict.val);
     return vm_none;
 }
 
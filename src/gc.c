@@ -1,29 +1,84 @@
 void vm_gc_grey(type_vm *tp,type_vmObj v) {
+    if (v.type == vm_enum1_fnc && (v.fnc.ftype&4)) { vm_gc_grey(tp,vm_misc_fnc_self(v)); }
     if (v.type < vm_enum1_string || (!v.gci.data) || *v.gci.data) { return; }
     *v.gci.data = 1;
-    if (v.type == vm_enum1_string || v.type == vm_enum1_data) {
+    if (v.type == vm_enum1_string || (v.type == vm_enum1_data && !v.data.info->follow)) {
         vm_list_appendx(tp,tp->black,v);
         return;
     }
     vm_list_appendx(tp,tp->grey,v);
 }
 
+/* Function: vm_gc_compact
+ * Replaces *v by a copy when it is a small view of a large string.
+ *
+ * Views share their parent's storage, so a short slice kept in a container
+ * would pin a huge buffer forever. The copy is made while the container is
+ * followed; the old view is still marked in this cycle in case C code is
+ * holding it, so the parent goes away in the next one. Only the first view
+ * of a parent met in a cycle is copied, since one that is already marked is
+ * still in use elsewhere, e.g. by the other pieces of a split.
+ */
+vm_inline static void vm_gc_compact(type_vm *tp,type_vmObj *v) {
+    type_vmString *info = v->string.info;
+    type_vmObj r;
+    if (v->type != vm_enum1_string || !info || info->gci || info->alloc < vm_def_COMPACT_PARENT ||
+        v->string.len*vm_def_COMPACT_RATIO > info->alloc) { return; }
+    vm_gc_grey(tp,*v);
+    r = vm_string_new(tp,v->string.len);
+    memcpy(r.string.info->s,v->string.val,v->string.len);
+    *v = r;
+}
+
+/* True if the items of a list sharing its storage were already followed in
+ * this cycle through another list, e.g. the one it was sliced from. Lists
+ * sharing a storage never change it, so this saves a slice of a slice of
+ * a long list from being scanned again and again. */
+static int vm_gc_covered(type_vm *tp, type_vmList *l) {
+    type_vmShare *s = l->share;
+    int lo = l->front, hi = l->front+l->len;
+    if (s->cycle == tp->cycles && lo >= s->lo && hi <= s->hi) { return 1; }
+    if (s->cycle != tp->cycles || hi < s->lo || lo > s->hi) {
+        s->cycle = tp->cycles; s->lo = lo; s->hi = hi;
+    } else {
+        s->lo = vm_min(s->lo,lo); s->hi = vm_max(s->hi,hi);
+    }
+    return 0;
+}
+
 void vm_gc_follow(type_vm *tp,type_vmObj v) {
     int type = v.type;
-    if (type == vm_enum1_list) {
+    if (type == vm_enum1_list && !v.list.val->nums && !(v.list.val->share && vm_gc_covered(tp,v.list.val))) {
+        type_vmList *l = v.list.val;
         int n;
-        for (n=0; n<v.list.val->len; n++) {
-            vm_gc_grey(tp,v.list.val->items[n]);
+        for (n=0; n<l->len; n++) {
+            type_vmObj *e = &l->items[n];
+            if (e->type < vm_enum1_string) { continue; }
+            if (!l->pinned) { vm_gc_compact(tp,e); }
+            vm_gc_grey(tp,*e);
         }
     }
     if (type == vm_enum1_dict) {
-        int i;
-        for (i=0; i<v.dict.val->len; i++) {
-            int n = vm_dict_next(tp,v.dict.val);
+        int n;
+        for (n=0; n<v.dict.val->used; n++) {
+            if (!v.dict.val->items[n].used) { continue; }
+            vm_gc_compact(tp,&v.dict.val->items[n].key);
+            vm_gc_compact(tp,&v.dict.val->items[n].val);
             vm_gc_grey(tp,v.dict.val->items[n].key);
             vm_gc_grey(tp,v.dict.val->items[n].val);
         }
-        vm_gc_grey(tp,v.dict.val->meta); 
+        vm_gc_grey(tp,v.dict.val->meta);
+        if (v.dict.val->mcache) {
+            for (n=0; n<vm_def_MCACHE; n++) {
+                type_vmMcache *c = &v.dict.val->mcache[n];
+                if (c->epoch != tp->meta_epoch) { continue; }
+                vm_gc_grey(tp,c->key);
+                vm_gc_grey(tp,c->val);
+            }
+        }
+    }
+    if (type == vm_enum1_data && v.data.info->follow) {
+        v.data.info->follow(tp,v);
     }
     if (type == vm_enum1_fnc) {
         vm_gc_grey(tp,v.fnc.info->self);
@@ -48,6 +103,7 @@ void vm_gc_init(type_vm *tp) {
     tp->grey = vm_list_new(tp);
     tp->black = vm_list_new(tp);
     tp->steps = 0;
+    tp->cycles = 0;
 }
 
 void vm_gc_deinit(type_vm *tp) {
@@ -65,6 +121,7 @@ void vm_gc_delete(type_vm *tp,type_vmObj v) {
         vm_dict_free(tp, v.dict.val);
         return;
     } else if (type == vm_enum1_string) {
+        free(v.string.info->uindex);
         free(v.string.info);
         return;
     } else if (type == vm_enum1_data) {
@@ -88,6 +145,7 @@ void vm_gc_collect(type_vm *tp) {
         vm_gc_delete(tp,r);
     }
     tp->white->len = 0;
+    tp->cycles += 1;
     vm_gc_reset(tp);
 }
 
@@ -1,18 +1,127 @@
+type_vmObj vm_list_slice(type_vm *tp, type_vmList *self, int a, int b);
+
+/* Bytes per item; packed lists hold bare numbers. */
+vm_inline static int vm_list_size(type_vmList *self) {
+    return self->nums ? sizeof(type_vmNum) : sizeof(type_vmObj);
+}
+
+/* Address of item n, which may be one of the front slots. Hot paths pass
+ * size as a constant so each storage kind gets its own code. */
+vm_inline static char *vm_list_ptr(type_vmList *self, int n, int size) {
+    return size == sizeof(type_vmObj) ? (char*)(self->items+n) : (char*)(self->nums+n);
+}
+
+/* Makes p the address of the first item. */
+vm_inline static void vm_list_point(type_vmList *self, char *p, int size) {
+    if (size == sizeof(type_vmObj)) { self->items = (type_vmObj*)p; } else { self->nums = (type_vmNum*)p; }
+}
+
+/* Stores v as item n, see <vm_list_fit>. */
+vm_inline static void vm_list_store(type_vmList *self, int n, type_vmObj v, int size) {
+    if (size == sizeof(type_vmObj)) { self->items[n] = v; } else { self->nums[n] = v.number.val; }
+}
+
+/* Item n of self, which must be in range. */
+vm_inline static type_vmObj vm_list_at(type_vmList *self, int n) {
+    return self->nums ? vm_create_numericObj(self->nums[n]) : self->items[n];
+}
+
+/* Function: vm_list_own
+ * Gives self storage of its own before it is changed.
+ *
+ * The last list using a shared storage keeps it; the others copy their
+ * items out. See <vm_list_slice>.
+ */
+static void vm_list_own(type_vmList *self) {
+    type_vmShare *share = self->share;
+    int size = vm_list_size(self);
+    char *base;
+    self->share = 0;
+    if (--share->refs == 0) { free(share); return; }
+    base = (char*)malloc(vm_max(1,self->len)*size);/*malloc(x)*/
+    if (self->len > 0) { memcpy(base,vm_list_ptr(self,0,size),size*self->len); }
+    vm_list_point(self,base,size);
+    self->front = 0;
+    self->alloc = vm_max(1,self->len);
+}
+
 void vm_list_realloc(type_vm *tp, type_vmList *self,int len) {
+    int size = vm_list_size(self);
+    char *base;
+    if (self->share) { vm_list_own(self); }
+    base = vm_list_ptr(self,-self->front,size);
     if (!len) { len=1; }
-    self->items = (type_vmObj*)realloc(self->items,len*sizeof(type_vmObj));/*realloc(x,y)*/
+    base = (char*)realloc(base,(self->front+len)*size);/*realloc(x,y)*/
+    vm_list_point(self,base+self->front*size,size);
     self->alloc = len;
 }
 
+/* Moves the items back to the start of the allocation. */
+static void vm_list_rewind(type_vmList *self) {
+    int size = vm_list_size(self);
+    char *base = vm_list_ptr(self,-self->front,size);
+    if (self->len) { memmove(base,vm_list_ptr(self,0,size),size*self->len); }
+    vm_list_point(self,base,size);
+    self->alloc += self->front;
+    self->front = 0;
+}
+
+/* Makes room for n items in front of the first one. */
+static void vm_list_headroom(type_vm *tp, type_vmList *self, int n) {
+    int size = vm_list_size(self);
+    char *base = (char*)malloc((n+self->alloc)*size);/*malloc(x)*/
+    if (self->len > 0) { memcpy(base+n*size,vm_list_ptr(self,0,size),size*self->len); }
+    free(vm_list_ptr(self,-self->front,size));
+    vm_list_point(self,base+n*size,size);
+    self->front = n;
+}
+
+/* Moves the numbers of a packed list into generic storage. */
+static void vm_list_unpack(type_vmList *self) {
+    type_vmObj *items = (type_vmObj*)malloc(vm_max(1,self->alloc)*sizeof(type_vmObj));/*malloc(x)*/
+    int n;
+    for (n=0; n<self->len; n++) { items[n] = vm_create_numericObj(self->nums[n]); }
+    free(self->nums-self->front);
+    self->nums = 0;
+    self->items = items;
+    self->front = 0;
+}
+
+/* Function: vm_list_fit
+ * Makes sure v can be stored in self.
+ *
+ * An empty list becomes packed when a number goes in: its items are kept
+ * as a bare <type_vmNum> array, a quarter of the size, with nothing for
+ * the collector to scan. The first item of any other type unpacks it
+ * again. The register and parameter lists are never packed, since C code
+ * holds pointers to their items.
+ */
+vm_inline static void vm_list_fit(type_vmList *self, type_vmObj v) {
+    if (v.type != vm_enum1_number) {
+        if (self->nums) { vm_list_unpack(self); }
+    } else if (!self->nums && !self->len && !self->pinned) {
+        int alloc = vm_max(4,self->front+self->alloc);
+        free(self->items-self->front);
+        self->items = 0;
+        self->nums = (type_vmNum*)malloc(alloc*sizeof(type_vmNum));/*malloc(x)*/
+        self->front = 0;
+        self->alloc = alloc;
+    }
+}
+
 void vm_list_set(type_vm *tp,type_vmList *self,int k, type_vmObj v, const char *error) {
     if (k >= self->len) {
         vm_raise(tp,vm_string("(vm_list_set) KeyError"));
     }
-    self->items[k] = v;
+    if (self->share) { vm_list_own(self); }
+    vm_list_fit(self,v);
+    vm_list_store(self,k,v,vm_list_size(self));
     vm_gc_grey(tp,v);
 }
 void vm_list_free(type_vm *tp, type_vmList *self) {
-    free(self->items);/*free(x)*/
+    if (self->share && --self->share->refs) { free(self); return; }
+    free(self->share);
+    free(vm_list_ptr(self,-self->front,vm_list_size(self)));/*free(x)*/
     free(self);
 }
 
@@ -20,17 +129,55 @@ type_vmObj vm_list_get(type_vm *tp,type_vmList *self,int k,const char *error) {
     if (k >= self->len) {
         vm_raise(0,vm_string("(vm_list_set) KeyError"));
     }
-    return self->items[k];
+    return vm_list_at(self,k);
 }
-void vm_list_insertx(type_vm *tp,type_vmList *self, int n, type_vmObj v) {
+
+vm_inline static void vm_list_insert_sub(type_vm *tp,type_vmList *self, int n, type_vmObj v, int size) {
+    if (n < self->len-n && (self->front || self->len >= vm_def_LIST_FRONT)) {
+        if (!self->front) { vm_list_headroom(tp,self,vm_max(4,self->len)); }
+        vm_list_point(self,vm_list_ptr(self,-1,size),size); self->front -= 1; self->alloc += 1;
+        if (n > 0) { memmove(vm_list_ptr(self,0,size),vm_list_ptr(self,1,size),size*n); }
+        vm_list_store(self,n,v,size);
+        self->len += 1;
+        return;
+    }
     if (self->len >= self->alloc) {
-        vm_list_realloc(tp, self,self->alloc*2);
+        if (self->front && self->front >= self->len) { vm_list_rewind(self); }
+        else { vm_list_realloc(tp, self,self->alloc*2); }
     }
-    if (n < self->len) { memmove(&self->items[n+1],&self->items[n],sizeof(type_vmObj)*(self->len-n)); }
-    self->items[n] = v;
+    if (n < self->len) { memmove(vm_list_ptr(self,n+1,size),vm_list_ptr(self,n,size),size*(self->len-n)); }
+    vm_list_store(self,n,v,size);
     self->len += 1;
 }
+
+/* Function: vm_list_insertx
+ * Inserts v before item n without a write barrier.
+ *
+ * Items before n move to the front when there are fewer of them, so
+ * inserting at the start costs O(1) amortized: the first such insert into
+ * a list without room makes as much room in front as the list has items.
+ * Lists shorter than vm_def_LIST_FRONT just move their tail, which keeps
+ * the parameter lists from allocating on every method call.
+ */
+void vm_list_insertx(type_vm *tp,type_vmList *self, int n, type_vmObj v) {
+    if (self->share) { vm_list_own(self); }
+    vm_list_fit(self,v);
+    if (self->nums) { vm_list_insert_sub(tp,self,n,v,sizeof(type_vmNum)); }
+    else { vm_list_insert_sub(tp,self,n,v,sizeof(type_vmObj)); }
+}
+/* Function: vm_list_appendx
+ * <vm_list_insertx> at the end, storing straight away when there is room
+ * and v needs no change of storage.
+ *
+ * This holds for shared storage too: slices never reach past the length
+ * of the list they were taken from, and a list only gets shorter through
+ * <vm_list_own>.
+ */
 void vm_list_appendx(type_vm *tp,type_vmList *self, type_vmObj v) {
+    if (self->len && self->len < self->alloc) {
+        if (!self->nums) { self->items[self->len++] = v; return; }
+        if (v.type == vm_enum1_number) { self->nums[self->len++] = v.number.val; return; }
+    }
     vm_list_insertx(tp,self,self->len,v);
 }
 void vm_list_insert(type_vm *tp,type_vmList *self, int n, type_vmObj v) {
@@ -38,19 +185,47 @@ void vm_list_insert(type_vm *tp,type_vmList *self, int n, type_vmObj v) {
     vm_gc_grey(tp,v);
 }
 void vm_list_append(type_vm *tp,type_vmList *self, type_vmObj v) {
-    vm_list_insert(tp,self,self->len,v);
+    vm_list_appendx(tp,self,v);
+    vm_gc_grey(tp,v);
 }
-type_vmObj vm_list_pop(type_vm *tp,type_vmList *self, int n, const char *error) {
-    type_vmObj r = vm_list_get(tp,self,n,error);
-    if (n != self->len-1) { memmove(&self->items[n],&self->items[n+1],sizeof(type_vmObj)*(self->len-(n+1))); }
+
+vm_inline static void vm_list_pop_sub(type_vmList *self, int n, int size) {
+    if (n < self->len-1-n) {
+        if (n) { memmove(vm_list_ptr(self,1,size),vm_list_ptr(self,0,size),size*n); }
+        vm_list_point(self,vm_list_ptr(self,1,size),size); self->front += 1; self->alloc -= 1;
+    } else if (n != self->len-1) {
+        memmove(vm_list_ptr(self,n,size),vm_list_ptr(self,n+1,size),size*(self->len-(n+1)));
+    }
     self->len -= 1;
+    if (!self->len && self->front) { vm_list_rewind(self); }
+}
+
+/* Function: vm_list_pop
+ * Removes and returns item n.
+ *
+ * Like <vm_list_insertx>, closes the gap from whichever side is shorter,
+ * so popping the first item is O(1).
+ */
+type_vmObj vm_list_pop(type_vm *tp,type_vmList *self, int n, const char *error) {
+    type_vmObj r;
+    if (n >= self->len) {
+        vm_raise(0,vm_string("(vm_list_set) KeyError"));
+    }
+    if (self->share) { vm_list_own(self); }
+    if (self->nums) {
+        r = vm_create_numericObj(self->nums[n]);
+        vm_list_pop_sub(self,n,sizeof(type_vmNum));
+        return r;
+    }
+    r = self->items[n];
+    vm_list_pop_sub(self,n,sizeof(type_vmObj));
     return r;
 }
 
 int vm_list_find(type_vm *tp,type_vmList *self, type_vmObj v) {
     int n;
     for (n=0; n<self->len; n++) {
-        if (vm_operations_cmp(tp,v,self->items[n]) == 0) {
+        if (vm_operations_cmp(tp,v,vm_list_at(self,n)) == 0) {
             return n;
         }
     }
@@ -74,10 +249,13 @@ type_vmList *vm_list_new(type_vm *tp) {
 type_vmObj vm_list_copy(type_vm *tp, type_vmObj rr) {
     type_vmObj val = {vm_enum1_list};
     type_vmList *o = rr.list.val;
-    type_vmList *r = vm_list_new(tp);
-    *r = *o; r->gci = 0;
-    r->items = (type_vmObj*)calloc(sizeof(type_vmObj)*o->len,1);
-    memcpy(r->items,o->items,sizeof(type_vmObj)*o->len);
+    type_vmList *r;
+    int size = vm_list_size(o);
+    if (o->len >= vm_def_LIST_VIEW && !o->pinned) { return vm_list_slice(tp,o,0,o->len); }
+    r = vm_list_new(tp);
+    *r = *o; r->share = 0; r->gci = 0; r->pinned = 0; r->front = 0; r->alloc = o->len;
+    vm_list_point(r,(char*)calloc(size*o->len,1),size);
+    if (o->len) { memcpy(vm_list_ptr(r,0,size),vm_list_ptr(o,0,size),size*o->len); }
     val.list.val = r;
     return vm_gc_track(tp,val);
 }
@@ -89,26 +267,87 @@ type_vmObj vm_list_append2(type_vm *tp) {
     return vm_none;
 }
 
+/* Function: vm_list_pop2
+ * list.pop([n]) removes and returns item n, the last one by default.
+ */
 type_vmObj vm_list_pop2(type_vm *tp) {
     type_vmObj self = vm_operations_get(tp,tp->params,vm_none);
-    return vm_list_pop(tp,self.list.val,self.list.val->len-1,"pop");
+    int n = vm_typecheck(tp,vm_enum1_number,vm_macros_DEFAULT(vm_create_numericObj(-1))).number.val;
+    n = n < 0 ? self.list.val->len+n : n;
+    if (n < 0 || n >= self.list.val->len) {
+        vm_raise(tp,vm_string("(vm_list_pop2) IndexError: pop index out of range"));
+    }
+    return vm_list_pop(tp,self.list.val,n,"pop");
 }
 
+/* Function: vm_list_insert2
+ * list.insert(n,v) inserts v before item n.
+ */
 type_vmObj vm_list_insert2(type_vm *tp) {
     type_vmObj self = vm_operations_get(tp,tp->params,vm_none);
     int n = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;
     type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
+    n = n < 0 ? self.list.val->len+n : n;
+    n = vm_max(0,vm_min(n,self.list.val->len));
     vm_list_insert(tp,self.list.val,n,v);
     return vm_none;
 }
 
+/* Makes room for n more items at the end of self. */
+static void vm_list_reserve(type_vm *tp, type_vmList *self, int n) {
+    if (self->share) { vm_list_own(self); }
+    if (self->len+n > self->alloc) { vm_list_realloc(tp,self,vm_max(self->alloc*2,self->len+n)); }
+}
+
+/* Function: vm_list_extendn
+ * Appends the n items from argv to self.
+ *
+ * Room is made once and the items are copied in one go; only items that
+ * are not numbers need the write barrier. When argv points into self,
+ * self must already have room for the n items.
+ */
+void vm_list_extendn(type_vm *tp, type_vmList *self, int n, type_vmObj const *argv) {
+    int i, numbers = 1;
+    if (n <= 0) { return; }
+    for (i=0; i<n && numbers; i++) { numbers = argv[i].type == vm_enum1_number; }
+    if (self->share) { vm_list_own(self); }
+    if (numbers) { vm_list_fit(self,argv[0]); }
+    else if (self->nums) { vm_list_unpack(self); }
+    vm_list_reserve(tp,self,n);
+    if (self->nums) {
+        for (i=0; i<n; i++) { self->nums[self->len+i] = argv[i].number.val; }
+    } else {
+        memcpy(self->items+self->len,argv,n*sizeof(type_vmObj));
+        for (i=0; i<n && !numbers; i++) { vm_gc_grey(tp,argv[i]); }
+    }
+    self->len += n;
+}
+
+/* Function: vm_list_extend_sub
+ * Appends the items of o, which may be self, to self.
+ */
+void vm_list_extend_sub(type_vm *tp, type_vmList *self, type_vmList *o) {
+    int n = o->len, i;
+    if (!n) { return; }
+    if (self->share) { vm_list_own(self); }
+    if (o->nums) { vm_list_fit(self,vm_create_numericObj(0)); }
+    vm_list_reserve(tp,self,n);
+    if (!o->nums) {
+        vm_list_extendn(tp,self,n,o->items);
+        return;
+    }
+    if (self->nums) {
+        memcpy(self->nums+self->len,o->nums,n*sizeof(type_vmNum));
+    } else {
+        for (i=0; i<n; i++) { self->items[self->len+i] = vm_create_numericObj(o->nums[i]); }
+    }
+    self->len += n;
+}
+
 type_vmObj vm_list_extend(type_vm *tp) {
     type_vmObj self = vm_operations_get(tp,tp->params,vm_none);
     type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
-    int i;
-    for (i=0; i<v.list.val->len; i++) {
-        vm_list_append(tp,self.list.val,v.list.val->items[i]);
-    }
+    vm_list_extend_sub(tp,self.list.val,vm_typecheck(tp,vm_enum1_list,v).list.val);
     return vm_none;
 }
 
@@ -125,21 +364,239 @@ type_vmObj vm_list(type_vm *tp) {
 }
 
 type_vmObj vm_list_n(type_vm *tp,int n,type_vmObj *argv) {
+    type_vmObj r = vm_list(tp);
+    vm_list_extendn(tp,r.list.val,n,argv);
+    return r;
+}
+
+/* Function: vm_list_packed
+ * A new packed list of n numbers for the caller to fill in.
+ */
+type_vmObj vm_list_packed(type_vm *tp, int n) {
+    type_vmObj r = vm_list(tp);
+    r.list.val->nums = (type_vmNum*)malloc(vm_max(1,n)*sizeof(type_vmNum));/*malloc(x)*/
+    r.list.val->len = n;
+    r.list.val->alloc = vm_max(1,n);
+    return r;
+}
+
+/* Function: vm_list_slice
+ * A new list holding items a to b of self.
+ *
+ * A slice of at least vm_def_LIST_VIEW items that covers at least half
+ * of the storage shares it with self instead of copying, until either
+ * list is changed, see <vm_list_own>. So xs[1:] costs O(1), while a
+ * small slice cannot keep a large storage alive.
+ */
+type_vmObj vm_list_slice(type_vm *tp, type_vmList *self, int a, int b) {
+    type_vmObj r;
+    type_vmList *l;
+    int size = vm_list_size(self), n = vm_max(0,b-a);
+    int total = self->share ? self->share->size : self->front+self->alloc;
+    if (n < vm_def_LIST_VIEW || n*2 < total || self->pinned) {
+        if (!self->nums) { return vm_list_n(tp,n,&self->items[a]); }
+        r = vm_list_packed(tp,n);
+        if (n) { memcpy(r.list.val->nums,&self->nums[a],n*sizeof(type_vmNum)); }
+        return r;
+    }
+    if (!self->share) {
+        self->share = (type_vmShare*)malloc(sizeof(type_vmShare));/*malloc(x)*/
+        self->share->refs = 1;
+        self->share->size = total;
+        self->share->cycle = -1;
+    }
+    self->share->refs += 1;
+    r = vm_list(tp);
+    l = r.list.val;
+    l->share = self->share;
+    vm_list_point(l,vm_list_ptr(self,a,size),size);
+    l->front = self->front+a;
+    l->len = l->alloc = n;
+    return r;
+}
+
+/* Function: vm_list_step
+ * A new list holding n items of self, from item a on in steps of step.
+ */
+type_vmObj vm_list_step(type_vm *tp, type_vmList *self, int a, int step, int n) {
+    type_vmObj r;
     int i;
-    type_vmObj r = vm_list(tp); vm_list_realloc(tp, r.list.val,n);
-    for (i=0; i<n; i++) {
-        vm_list_append(tp,r.list.val,argv[i]);
+    if (self->nums) {
+        r = vm_list_packed(tp,n);
+        for (i=0; i<n; i++) { r.list.val->nums[i] = self->nums[a+i*step]; }
+        return r;
     }
+    r = vm_list(tp);
+    vm_list_realloc(tp,r.list.val,n);
+    for (i=0; i<n; i++) { vm_list_append(tp,r.list.val,self->items[a+i*step]); }
     return r;
 }
 
-int vm_list_sort_cmp(type_vmObj *a,type_vmObj *b) {
-    return vm_operations_cmp(0,*a,*b);
+/* A list item and the key it is sorted by. */
+typedef struct type_vmSortItem {
+    type_vmObj key;
+    type_vmObj val;
+} type_vmSortItem;
+
+/* How keys are compared: any types, all numbers or all strings. */
+enum { vm_list_SORT_ANY, vm_list_SORT_NUMBER, vm_list_SORT_STRING };
+
+#define vm_def_SORT_RUN 16
+
+vm_inline static int vm_list_less(type_vm *tp, int mode, type_vmObj *a, type_vmObj *b) {
+    if (mode == vm_list_SORT_NUMBER) { return a->number.val < b->number.val; }
+    if (mode == vm_list_SORT_STRING) {
+        int v;
+        if (a->string.len && b->string.len && a->string.val[0] != b->string.val[0]) {
+            return (unsigned char)a->string.val[0] < (unsigned char)b->string.val[0];
+        }
+        v = memcmp(a->string.val,b->string.val,vm_min(a->string.len,b->string.len));
+        return v ? v < 0 : a->string.len < b->string.len;
+    }
+    return vm_operations_cmp(tp,*a,*b) < 0;
+}
+
+/* True if item b goes before item a, which is never so for equal keys. */
+vm_inline static int vm_list_before(type_vm *tp, int mode, int reverse, type_vmSortItem *b, type_vmSortItem *a) {
+    return reverse ? vm_list_less(tp,mode,&a->key,&b->key) : vm_list_less(tp,mode,&b->key,&a->key);
+}
+
+static void vm_list_insertion_sort(type_vm *tp, int mode, int reverse, type_vmSortItem *v, int n) {
+    int i, j;
+    for (i=1; i<n; i++) {
+        type_vmSortItem t = v[i];
+        for (j=i; j>0 && vm_list_before(tp,mode,reverse,&t,&v[j-1]); j--) { v[j] = v[j-1]; }
+        v[j] = t;
+    }
+}
+
+/* Merges the sorted runs v[a:m] and v[m:b] using tmp, which has room for m-a items. */
+static void vm_list_merge(type_vm *tp, int mode, int reverse, type_vmSortItem *v, type_vmSortItem *tmp, int a, int m, int b) {
+    int i = 0, j = m, k = a, n = m-a;
+    if (!vm_list_before(tp,mode,reverse,&v[m],&v[m-1])) { return; }
+    memcpy(tmp,&v[a],sizeof(type_vmSortItem)*n);
+    while (i < n && j < b) {
+        v[k++] = vm_list_before(tp,mode,reverse,&v[j],&tmp[i]) ? v[j++] : tmp[i++];
+    }
+    while (i < n) { v[k++] = tmp[i++]; }
+}
+
+/* Function: vm_list_sort_sub
+ * Stable sort of n items by key, using tmp, which has room for n items.
+ *
+ * Runs of vm_def_SORT_RUN items are insertion sorted and then merged
+ * bottom up; adjacent runs already in order are not copied, so sorted
+ * input costs n comparisons.
+ */
+void vm_list_sort_sub(type_vm *tp, type_vmSortItem *v, type_vmSortItem *tmp, int n, int reverse) {
+    int mode = vm_list_SORT_NUMBER, i, w;
+    for (i=0; i<n; i++) {
+        if (v[i].key.type != vm_enum1_number) { mode = vm_list_SORT_ANY; break; }
+    }
+    if (mode == vm_list_SORT_ANY) {
+        mode = vm_list_SORT_STRING;
+        for (i=0; i<n; i++) {
+            if (v[i].key.type != vm_enum1_string) { mode = vm_list_SORT_ANY; break; }
+        }
+    }
+    for (i=0; i<n; i+=vm_def_SORT_RUN) {
+        vm_list_insertion_sort(tp,mode,reverse,&v[i],vm_min(vm_def_SORT_RUN,n-i));
+    }
+    if (n <= vm_def_SORT_RUN) { return; }
+    for (w=vm_def_SORT_RUN; w<n; w*=2) {
+        for (i=0; i+w<n; i+=2*w) {
+            vm_list_merge(tp,mode,reverse,v,tmp,i,i+w,vm_min(i+2*w,n));
+        }
+    }
+}
+
+static int vm_list_numcmp(const void *a, const void *b) {
+    type_vmNum x = *(type_vmNum const*)a, y = *(type_vmNum const*)b;
+    return (x > y) - (x < y);
+}
+
+static int vm_list_numcmp_r(const void *a, const void *b) {
+    return vm_list_numcmp(b,a);
+}
+
+/* Removes the sort list items from the root, where it is the last entry
+ * added by this sort. */
+static void vm_list_unroot(type_vm *tp, type_vmObj items) {
+    type_vmList *root = tp->root.list.val;
+    int i;
+    for (i=root->len-1; root->items[i].list.val != items.list.val; i--) { }
+    vm_list_pop(tp,root,i,"vm_list_sort");
 }
 
+/* Function: vm_list_sort
+ * list.sort(key=None,reverse=False) sorts the list in place.
+ *
+ * The sort is stable. When key is given, the items and then their keys are
+ * gathered in one list reachable from the root before key is first called,
+ * so the collector cannot free either while key runs, even if key changes
+ * the list. Anything raised while sorting frees the sort buffer and unroots
+ * that list before it is raised on.
+ */
 type_vmObj vm_list_sort(type_vm *tp) {
     type_vmObj self = vm_operations_get(tp,tp->params,vm_none);
-    qsort(self.list.val->items, self.list.val->len, sizeof(type_vmObj), (int(*)(const void*,const void*))vm_list_sort_cmp);
+    type_vmObj opts = vm_macros_DEFAULT(vm_none);
+    type_vmObj key = vm_none, items = vm_none;
+    type_vmList *l = self.list.val;
+    type_vmSortItem * volatile v = 0;
+    jmp_buf outer;
+    int reverse = 0, n = l->len, i;
+    if (opts.type == vm_enum1_dict) {
+        if (vm_operations_haskey(tp,opts,vm_string("key")).number.val) {
+            key = vm_operations_get(tp,opts,vm_string("key"));
+        }
+        if (vm_operations_haskey(tp,opts,vm_string("reverse")).number.val) {
+            reverse = vm_operations_bool(tp,vm_operations_get(tp,opts,vm_string("reverse")));
+        }
+    } else if (opts.type != vm_enum1_none) {
+        key = opts;
+    }
+    if (n < 2) { return vm_none; }
+    if (l->nums && key.type == vm_enum1_none) {
+        if (l->share) { vm_list_own(l); }
+        qsort(l->nums,n,sizeof(type_vmNum),reverse ? vm_list_numcmp_r : vm_list_numcmp);
+        return vm_none;
+    }
+    if (key.type != vm_enum1_none) {
+        items = vm_list(tp);
+        vm_list_append(tp,tp->root.list.val,items);
+    }
+    memcpy(outer,tp->buf,sizeof(jmp_buf));
+    if (setjmp(tp->buf)) {
+        memcpy(tp->buf,outer,sizeof(jmp_buf));
+        free(v);
+        if (items.type != vm_enum1_none) { vm_list_unroot(tp,items); }
+        vm_raise(tp,vm_none);
+    }
+    if (key.type != vm_enum1_none) {
+        vm_list_extend_sub(tp,items.list.val,l);
+        for (i=0; i<n; i++) {
+            type_vmObj k = vm_call_sub(tp,key,vm_misc_params_v(tp,1,vm_list_at(items.list.val,i)));
+            vm_list_append(tp,items.list.val,k);
+        }
+        if (l->len != n) {
+            vm_raise(tp,vm_string("(vm_list_sort) ValueError: list modified during sort"));
+        }
+    }
+    v = (type_vmSortItem*)malloc(sizeof(type_vmSortItem)*n*2);/*malloc(x)*/
+    for (i=0; i<n; i++) {
+        if (key.type != vm_enum1_none) {
+            v[i].val = vm_list_at(items.list.val,i);
+            v[i].key = vm_list_at(items.list.val,n+i);
+        } else {
+            v[i].key = v[i].val = vm_list_at(l,i);
+        }
+    }
+    vm_list_sort_sub(tp,v,v+n,n,reverse);
+    memcpy(tp->buf,outer,sizeof(jmp_buf));
+    if (l->share) { vm_list_own(l); }
+    for (i=0; i<n; i++) { vm_list_store(l,i,v[i].val,vm_list_size(l)); }
+    free(v);
+    if (items.type != vm_enum1_none) { vm_list_unroot(tp,items); }
     return vm_none;
 }
 
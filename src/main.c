@@ -1,9 +1,11 @@
 #include "vm.c"
 #include "modules/math/init.c"
+#include "modules/ndarray/init.c"
 
 int main(int argc, char *argv[]) {
     type_vm *vm = vm_init(argc,argv);
     math_init(vm);
+    ndarray_init(vm);
     vm_call(vm,"obfuscatedDataType","interp",vm_none);
     vm_deinit(vm);
     return(0);
@@ -5,9 +5,31 @@
 type_vmObj vm_misc_dcall(type_vm *tp,type_vmObj fnc(type_vm *tp)) {
     return fnc(tp);
 }
+/* Function types (fnc.ftype) are a set of flags:
+ * 1 - Script function, info->code holds its code. Otherwise cfnc is the C
+ *     function to call.
+ * 2 - Method, self is passed as the first parameter.
+ * 4 - Method bound without an allocation: info is shared with the plain
+ *     function and cfnc holds the dict of the object it is bound to.
+ *     Only used for script functions, see <vm_misc_bind>.
+ */
+
+/* Function: vm_misc_fnc_self
+ * The object a method is bound to.
+ */
+type_vmObj vm_misc_fnc_self(type_vmObj fnc) {
+    if (fnc.fnc.ftype&4) {
+        type_vmObj r = {vm_enum1_dict};
+        r.dict.val = (type_vmDict*)fnc.fnc.cfnc;
+        r.dict.dtype = 2;
+        return r;
+    }
+    return fnc.fnc.info->self;
+}
+
 type_vmObj vm_misc_tcall(type_vm *tp,type_vmObj fnc) {
     if (fnc.fnc.ftype&2) {
-        vm_list_insert(tp,tp->params.list.val,0,fnc.fnc.info->self);
+        vm_list_insert(tp,tp->params.list.val,0,vm_misc_fnc_self(fnc));
     }
     return vm_misc_dcall(tp,(type_vmObj (*)(type_vm *))fnc.fnc.cfnc);
 }
@@ -24,6 +46,24 @@ type_vmObj vm_misc_fnc_new(type_vm *tp,int t, void *v, type_vmObj c,type_vmObj s
     return vm_gc_track(tp,r);
 }
 
+/* Function: vm_misc_bind
+ * Binds the function fnc to self, making it a method.
+ *
+ * Script functions bound to an object only need a different flag and the
+ * object's dict in the same value, so no new function object is
+ * allocated. Everything else gets a new function object holding self.
+ */
+type_vmObj vm_misc_bind(type_vm *tp,type_vmObj fnc, type_vmObj self) {
+    if ((fnc.fnc.ftype&1) && self.type == vm_enum1_dict && self.dict.dtype == 2) {
+        fnc.fnc.ftype |= 6;
+        fnc.fnc.cfnc = self.dict.val;
+        return fnc;
+    }
+    return vm_misc_fnc_new(tp,(fnc.fnc.ftype|2)&~4,
+        (fnc.fnc.ftype&4)?0:fnc.fnc.cfnc,fnc.fnc.info->code,
+        self,fnc.fnc.info->globals);
+}
+
 type_vmObj vm_misc_def(type_vm *tp,type_vmObj code, type_vmObj g) {
     type_vmObj r = vm_misc_fnc_new(tp,1,0,code,vm_none,g);
     return r;
@@ -35,7 +35,7 @@ void math_init(type_vm *tp)
     vm_operations_set(tp, math_mod, vm_string("fmod"), vm_misc_fnc(tp, math_fmod));
     vm_operations_set(tp, math_mod, vm_string("frexp"), vm_misc_fnc(tp, math_frexp));
     vm_operations_set(tp, math_mod, vm_string("hypot"), vm_misc_fnc(tp, math_hypot));
-    vm_operations_set(tp, math_mod, vm_string("ldexp"), vm_misc_fnc(tp, math_ldexp));
+    vm_operations_set(tp, math_mod, vm_string("ldexp"), vm_misc_fnc(tp, math_ldexpd));
     vm_operations_set(tp, math_mod, vm_string("log"), vm_misc_fnc(tp, math_log));
     vm_operations_set(tp, math_mod, vm_string("log10"), vm_misc_fnc(tp, math_log10));
     vm_operations_set(tp, math_mod, vm_string("modf"), vm_misc_fnc(tp, math_modf));
@@ -8,18 +8,98 @@
 
 #include <errno.h>
 
+/*
+ * a new packed list holding the numbers of v when it is
+ * a list, or n copies of v when it is a number.
+ */
+static type_vmObj math_numbers(type_vm *tp, type_vmObj v, int n) {
+    type_vmObj r = vm_list_packed(tp, n);
+    int i;
+    if (v.type != vm_enum1_list) {
+        double x = vm_typecheck(tp,vm_enum1_number,v).number.val;
+        for (i = 0; i < n; i++) { r.list.val->nums[i] = x; }
+    } else if (v.list.val->nums) {
+        memcpy(r.list.val->nums, v.list.val->nums, n*sizeof(type_vmNum));
+    } else {
+        for (i = 0; i < n; i++) {
+            r.list.val->nums[i] = vm_typecheck(tp,vm_enum1_number,vm_list_at(v.list.val,i)).number.val;
+        }
+    }
+    return r;
+}
+
+/*
+ * length of the list among x and y; both must have
+ * the same length when both are lists.
+ */
+static int math_length(type_vm *tp, type_vmObj x, type_vmObj y) {
+    if (x.type == vm_enum1_list && y.type == vm_enum1_list &&
+        x.list.val->len != y.list.val->len) {
+        vm_raise(tp, vm_string("(math_length) ValueError: lists differ in length"));
+    }
+    return x.type == vm_enum1_list ? x.list.val->len : y.list.val->len;
+}
+
+/*
+ * raise for the first of n items that is out of range
+ * of f, once an element-wise loop has set errno.
+ */
+static void math_raise1(type_vm *tp, const char *name, double (*f)(double), double const *x, int n) {
+    int i;
+    for (i = 0; i < n; i++) {
+        errno = 0;
+        f(x[i]);
+        if (errno == EDOM || errno == ERANGE) {
+            vm_raise(tp, vm_string_printf(tp, "%s(x): x[%d]=%f "
+                                        "out of range", name, i, x[i]));
+        }
+    }
+}
+
+static void math_raise2(type_vm *tp, const char *name, double (*f)(double, double), double const *x, double const *y, int n) {
+    int i;
+    for (i = 0; i < n; i++) {
+        errno = 0;
+        f(x[i], y[i]);
+        if (errno == EDOM || errno == ERANGE) {
+            vm_raise(tp, vm_string_printf(tp, "%s(x, y): x[%d]=%f,y[%d]=%f "
+                                        "out of range", name, i, x[i], i, y[i]));
+        }
+    }
+}
+
 /*
  * template for interpreter math functions
  * with one parameter. 
  *
  * @cfunc is the coresponding function name in C
  * math library.
+ *
+ * given a list, cfunc is applied to every item and
+ * a new list is returned. the loop calls cfunc
+ * directly, so the compiler may inline or vectorize
+ * it, and errno is only checked once at the end.
  */
 #define interpreter_MATH_FUNC1(cfunc)                        \
     static type_vmObj math_##cfunc(type_vm *tp) {                \
-        double x = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;                        \
+        type_vmObj v = vm_operations_get(tp,tp->params,vm_none); \
+        double x = 0.0;                             \
         double r = 0.0;                             \
                                                     \
+        if (v.type == vm_enum1_list) {              \
+            int i, n = v.list.val->len;             \
+            type_vmObj in = v.list.val->nums ? v : math_numbers(tp, v, n); \
+            type_vmObj out = vm_list_packed(tp, n); \
+            double const *a = in.list.val->nums;    \
+            double *o = out.list.val->nums;         \
+            errno = 0;                              \
+            for (i = 0; i < n; i++) { o[i] = cfunc(a[i]); } \
+            if (errno == EDOM || errno == ERANGE) { \
+                math_raise1(tp, __func__, cfunc, a, n); \
+            }                                       \
+            return out;                             \
+        }                                           \
+        x = vm_typecheck(tp,vm_enum1_number,v).number.val; \
         errno = 0;                                  \
         r = cfunc(x);                               \
         if (errno == EDOM || errno == ERANGE) {     \
@@ -36,13 +116,34 @@
  *
  * @cfunc is the coresponding function name in C
  * math library.
+ *
+ * either parameter may be a list, in which case
+ * the result is a list as with interpreter_MATH_FUNC1;
+ * a number is paired with every item of the other.
  */
 #define interpreter_MATH_FUNC2(cfunc)                        \
     static type_vmObj math_##cfunc(type_vm *tp) {                \
-        double x = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;                        \
-        double y = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;                        \
+        type_vmObj vx = vm_operations_get(tp,tp->params,vm_none); \
+        type_vmObj vy = vm_operations_get(tp,tp->params,vm_none); \
+        double x = 0.0;                             \
+        double y = 0.0;                             \
         double r = 0.0;                             \
                                                     \
+        if (vx.type == vm_enum1_list || vy.type == vm_enum1_list) { \
+            int i, n = math_length(tp, vx, vy);     \
+            double const *a = math_numbers(tp, vx, n).list.val->nums; \
+            double const *b = math_numbers(tp, vy, n).list.val->nums; \
+            type_vmObj out = vm_list_packed(tp, n); \
+            double *o = out.list.val->nums;         \
+            errno = 0;                              \
+            for (i = 0; i < n; i++) { o[i] = cfunc(a[i], b[i]); } \
+            if (errno == EDOM || errno == ERANGE) { \
+                math_raise2(tp, __func__, cfunc, a, b, n); \
+            }                                       \
+            return out;                             \
+        }                                           \
+        x = vm_typecheck(tp,vm_enum1_number,vx).number.val; \
+        y = vm_typecheck(tp,vm_enum1_number,vy).number.val; \
         errno = 0;                                  \
         r = cfunc(x, y);                            \
         if (errno == EDOM || errno == ERANGE) {     \
@@ -209,8 +310,14 @@ interpreter_MATH_FUNC2(hypot)
  *
  * return the result of multiplying x by 2
  * raised to y.
+ *
+ * the C ldexp takes an int y, ldexpd fits the template.
  */
-interpreter_MATH_FUNC2(ldexp)
+static double ldexpd(double x, double y)
+{
+    return (ldexp(x, (int)y));
+}
+interpreter_MATH_FUNC2(ldexpd)
 
 /*
  * log(x, [base])
@@ -296,20 +403,7 @@ static type_vmObj math_modf(type_vm *tp) {
  * of builtin function pow(); whilst, math_pow() is an
  * alternative in math module.
  */
-static type_vmObj math_pow(type_vm *tp) {
-    double x = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;
-    double y = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;
-    double r = 0.0;
-
-    errno = 0;
-    r = pow(x, y);
-    if (errno == EDOM || errno == ERANGE) {
-        vm_raise(0, vm_string_printf(tp, "%s(x, y): x=%f,y=%f "
-                                    "out of range", __func__, x, y));
-    }
-
-    return (vm_create_numericObj(r));
-}
+interpreter_MATH_FUNC2(pow)
 
 
 /*
@@ -173,4 +173,35 @@ testit('tan(-pi/4)', math.tan(-math.pi/4), -1)
 testit('tanh(0)', math.tanh(0), 0)
 testit('tanh(1)+tanh(-1)', math.tanh(1)+math.tanh(-1), 0)
 
+#print 'lists'
+r = math.sqrt([0, 1, 4, 9])
+testit('sqrt([0,1,4,9])', r[0] + r[1] * 10 + r[2] * 100 + r[3] * 1000, 3210)
+r = math.sin([0, math.pi/2])
+testit('sin([0,pi/2])', r[0] + r[1], 1)
+r = math.pow([1, 2, 3], 2)
+testit('pow([1,2,3],2)', r[0] + r[1] + r[2], 14)
+r = math.atan2(1, [1, 0])
+testit('atan2(1,[1,0])', r[0] + r[1], 3*math.pi/4)
+r = math.fmod([7, 8], [4, 5])
+testit('fmod([7,8],[4,5])', r[0] * 10 + r[1], 33)
+r = math.ldexp([1, 3], [2, 1])
+testit('ldexp([1,3],[2,1])', r[0] * 10 + r[1], 46)
+testit('floor([])', len(math.floor([])), 0)
+m = [1, 4]
+m.append(16)
+m[0] = 9
+testit('sqrt(unpacked)', math.sqrt(m)[0], 3)
+caught = 0
+try:
+    math.acos([0.5, 2])
+except:
+    caught = 1
+testit('acos([0.5,2]) raises', caught, 1)
+caught = 0
+try:
+    math.pow([1, 2], [1, 2, 3])
+except:
+    caught = 1
+testit('pow length mismatch raises', caught, 1)
+
 #print("OK: math module test pass")
@@ -0,0 +1,34 @@
+#include "ndarray.c"
+
+/*
+ * init ndarray module, namely, set its dictionary
+ */
+void ndarray_init(type_vm *tp)
+{
+    /*
+     * new a module dict for ndarray
+     */
+    type_vmObj ndarray_mod = vm_dict_create(tp);
+
+    /*
+     * bind ndarray functions to ndarray module
+     */
+    vm_operations_set(tp, ndarray_mod, vm_string("array"), vm_misc_fnc(tp, ndarray_array_new));
+    vm_operations_set(tp, ndarray_mod, vm_string("zeros"), vm_misc_fnc(tp, ndarray_zeros));
+    vm_operations_set(tp, ndarray_mod, vm_string("arange"), vm_misc_fnc(tp, ndarray_arange));
+
+    /*
+     * bind special attributes to ndarray module
+     */
+    vm_operations_set(tp, ndarray_mod, vm_string("__doc__"),
+            vm_string(
+                "Contiguous float64 and int64 arrays with element-wise\n"
+                "arithmetic and native reductions."));
+    vm_operations_set(tp, ndarray_mod, vm_string("__name__"), vm_string("ndarray"));
+    vm_operations_set(tp, ndarray_mod, vm_string("__file__"), vm_string(__FILE__));
+
+    /*
+     * bind to tiny modules[]
+     */
+    vm_operations_set(tp, tp->modules, vm_string("ndarray"), ndarray_mod);
+}
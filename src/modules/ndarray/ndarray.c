@@ -0,0 +1,417 @@
+/*
+ * ndarray: contiguous one dimensional arrays of float64
+ * or int64 numbers.
+ *
+ * an array is a view, off and len, of a reference counted
+ * buffer as with bytearray, so a[4:8] copies nothing and
+ * writes through either view are seen by both. arithmetic
+ * with + - * / runs element-wise over whole arrays, a
+ * number on either side being paired with every element.
+ *
+ * int64 is stored as a C long, which is 64 bits on the
+ * LP64 targets sparrow is built for.
+ */
+
+enum { NDARRAY_FLOAT64, NDARRAY_INT64 };
+
+typedef struct ndarray_buffer {
+    int refs;
+    int dtype;
+    int len;
+    void *v;
+} ndarray_buffer;
+
+typedef struct ndarray_array {
+    ndarray_buffer *buf;
+    int off;
+    int len;
+} ndarray_array;
+
+static type_vmObj ndarray_view(type_vm *tp, ndarray_buffer *buf, int off, int len);
+
+static ndarray_array *ndarray_of(type_vmObj self) {
+    return (ndarray_array *)self.data.val;
+}
+
+static ndarray_array *ndarray_self(type_vm *tp) {
+    return ndarray_of(vm_operations_get(tp, tp->params, vm_none));
+}
+
+static int ndarray_is(type_vmObj v) {
+    return v.type == vm_enum1_data && v.data.magic == vm_enum3_ndarray;
+}
+
+static double *ndarray_d(ndarray_array *a) {
+    return (double *)a->buf->v + a->off;
+}
+
+static long *ndarray_l(ndarray_array *a) {
+    return (long *)a->buf->v + a->off;
+}
+
+/*
+ * a new array of n uninitialized elements.
+ */
+static type_vmObj ndarray_new(type_vm *tp, int dtype, int n) {
+    ndarray_buffer *buf = (ndarray_buffer *)calloc(sizeof(ndarray_buffer), 1);/*calloc((x),1)*/
+    buf->dtype = dtype;
+    buf->len = n;
+    buf->v = malloc(vm_max(1, n) * (dtype == NDARRAY_INT64 ? sizeof(long) : sizeof(double)));/*malloc(x)*/
+    return ndarray_view(tp, buf, 0, n);
+}
+
+/*
+ * element n of a as a number.
+ */
+static double ndarray_at(ndarray_array *a, int n) {
+    return a->buf->dtype == NDARRAY_INT64 ? (double)ndarray_l(a)[n] : ndarray_d(a)[n];
+}
+
+/*
+ * the elements of a as doubles: a itself for float64, or
+ * a float64 copy of an int64 array.
+ */
+static double const *ndarray_asd(type_vm *tp, ndarray_array *a) {
+    type_vmObj r;
+    long const *s;
+    double *d;
+    int i;
+    if (a->buf->dtype == NDARRAY_FLOAT64) { return ndarray_d(a); }
+    r = ndarray_new(tp, NDARRAY_FLOAT64, a->len);
+    s = ndarray_l(a);
+    d = ndarray_d(ndarray_of(r));
+    for (i = 0; i < a->len; i++) { d[i] = (double)s[i]; }
+    return d;
+}
+
+/*
+ * the dtype named by the string v.
+ */
+static int ndarray_dtype_of(type_vm *tp, type_vmObj v) {
+    if (vm_operations_cmp(tp, v, vm_string("float64")) == 0) { return NDARRAY_FLOAT64; }
+    if (vm_operations_cmp(tp, v, vm_string("int64")) == 0) { return NDARRAY_INT64; }
+    vm_raise(tp, vm_string("(ndarray_dtype_of) ValueError: dtype must be 'float64' or 'int64'"));
+    return 0;
+}
+
+/*
+ * the dtype passed after the other parameters, either as
+ * a string or as dtype=; float64 when there is none.
+ */
+static int ndarray_dtype(type_vm *tp) {
+    type_vmObj v;
+    if (!tp->params.list.val->len) { return NDARRAY_FLOAT64; }
+    v = vm_operations_get(tp, tp->params, vm_none);
+    if (v.type == vm_enum1_dict) {
+        if (!vm_operations_haskey(tp, v, vm_string("dtype")).number.val) { return NDARRAY_FLOAT64; }
+        v = vm_operations_get(tp, v, vm_string("dtype"));
+    }
+    return ndarray_dtype_of(tp, v);
+}
+
+/*
+ * element-wise kernels. r[i] = x[i*sx] op y[i*sy], where a
+ * stride of 0 pairs a single number with every element.
+ */
+#ifdef __SSE2__
+#define NDARRAY_LOOPD(simd, op)                             \
+    {                                                       \
+        __m128d xs = _mm_set1_pd(x[0]), ys = _mm_set1_pd(y[0]); \
+        for (; i + 2 <= n; i += 2) {                        \
+            __m128d a = sx ? _mm_loadu_pd(x + i) : xs;      \
+            __m128d b = sy ? _mm_loadu_pd(y + i) : ys;      \
+            _mm_storeu_pd(r + i, simd(a, b));               \
+        }                                                   \
+        for (; i < n; i++) { r[i] = x[i * sx] op y[i * sy]; } \
+    }
+#else
+#define NDARRAY_LOOPD(simd, op)                             \
+    for (; i < n; i++) { r[i] = x[i * sx] op y[i * sy]; }
+#endif
+
+static void ndarray_kerneld(int op, double *r, double const *x, int sx, double const *y, int sy, int n) {
+    int i = 0;
+    if (n <= 0) { return; }
+    switch (op) {
+        case vm_enum2_ADD: NDARRAY_LOOPD(_mm_add_pd, +) break;
+        case vm_enum2_SUB: NDARRAY_LOOPD(_mm_sub_pd, -) break;
+        case vm_enum2_MUL: NDARRAY_LOOPD(_mm_mul_pd, *) break;
+        case vm_enum2_DIV: NDARRAY_LOOPD(_mm_div_pd, /) break;
+    }
+}
+
+static void ndarray_kernell(int op, long *r, long const *x, int sx, long const *y, int sy, int n) {
+    int i;
+    switch (op) {
+        case vm_enum2_ADD: for (i = 0; i < n; i++) { r[i] = x[i * sx] + y[i * sy]; } break;
+        case vm_enum2_SUB: for (i = 0; i < n; i++) { r[i] = x[i * sx] - y[i * sy]; } break;
+        case vm_enum2_MUL: for (i = 0; i < n; i++) { r[i] = x[i * sx] * y[i * sy]; } break;
+    }
+}
+
+/*
+ * true if the number v fits an int64 element exactly.
+ */
+static int ndarray_integral(double v) {
+    return v == floor(v) && fabs(v) < 9.2e18;
+}
+
+/*
+ * a op b where a or b is an array and the other is an
+ * array of the same length or a number. int64 stays int64
+ * for + - * with int64 arrays and integral numbers, any
+ * other mix and every / give float64.
+ */
+static type_vmObj ndarray_arith(type_vm *tp, int op, type_vmObj a, type_vmObj b) {
+    ndarray_array *x = ndarray_is(a) ? ndarray_of(a) : 0;
+    ndarray_array *y = ndarray_is(b) ? ndarray_of(b) : 0;
+    double dx = 0.0, dy = 0.0;
+    int n, isint;
+    type_vmObj r;
+    if (op != vm_enum2_ADD && op != vm_enum2_SUB && op != vm_enum2_MUL && op != vm_enum2_DIV) {
+        vm_raise(tp, vm_string("(ndarray_arith) TypeError: unsupported operand for ndarray"));
+    }
+    if (!x) { dx = vm_typecheck(tp, vm_enum1_number, a).number.val; }
+    if (!y) { dy = vm_typecheck(tp, vm_enum1_number, b).number.val; }
+    if (x && y && x->len != y->len) {
+        vm_raise(tp, vm_string("(ndarray_arith) ValueError: arrays differ in length"));
+    }
+    n = x ? x->len : y->len;
+    isint = op != vm_enum2_DIV &&
+        (x ? x->buf->dtype == NDARRAY_INT64 : ndarray_integral(dx)) &&
+        (y ? y->buf->dtype == NDARRAY_INT64 : ndarray_integral(dy));
+    if (isint) {
+        long lx = (long)dx, ly = (long)dy;
+        r = ndarray_new(tp, NDARRAY_INT64, n);
+        ndarray_kernell(op, ndarray_l(ndarray_of(r)),
+            x ? ndarray_l(x) : &lx, x != 0, y ? ndarray_l(y) : &ly, y != 0, n);
+        return r;
+    }
+    r = ndarray_new(tp, NDARRAY_FLOAT64, n);
+    ndarray_kerneld(op, ndarray_d(ndarray_of(r)),
+        x ? ndarray_asd(tp, x) : &dx, x != 0, y ? ndarray_asd(tp, y) : &dy, y != 0, n);
+    return r;
+}
+
+/*
+ * index k of a, counting back from the end when negative.
+ */
+static int ndarray_index(type_vm *tp, ndarray_array *a, type_vmObj k) {
+    int n = vm_typecheck(tp, vm_enum1_number, k).number.val;
+    n = n < 0 ? a->len + n : n;
+    if (n < 0 || n >= a->len) {
+        vm_raise(tp, vm_string("(ndarray_index) IndexError: ndarray index out of range"));
+    }
+    return n;
+}
+
+static void ndarray_put(ndarray_array *a, int n, double v) {
+    if (a->buf->dtype == NDARRAY_INT64) { ndarray_l(a)[n] = (long)v; }
+    else { ndarray_d(a)[n] = v; }
+}
+
+static type_vmObj ndarray_sum(type_vm *tp) {
+    ndarray_array *a = ndarray_self(tp);
+    long r = 0;
+    int i;
+    if (a->buf->dtype == NDARRAY_FLOAT64) {
+        return vm_create_numericObj(vm_api_stat_sumd(ndarray_d(a), a->len));
+    }
+    for (i = 0; i < a->len; i++) { r += ndarray_l(a)[i]; }
+    return vm_create_numericObj(r);
+}
+
+static type_vmObj ndarray_mean(type_vm *tp) {
+    ndarray_array *a = ndarray_self(tp);
+    if (!a->len) {
+        vm_raise(tp, vm_string("(ndarray_mean) ValueError: mean of an empty ndarray"));
+    }
+    return vm_create_numericObj(vm_api_stat_sumd(ndarray_asd(tp, a), a->len) / a->len);
+}
+
+static type_vmObj ndarray_extreme(type_vm *tp, int max) {
+    ndarray_array *a = ndarray_self(tp);
+    long const *v;
+    long r;
+    int i;
+    if (!a->len) {
+        vm_raise(tp, vm_string("(ndarray_extreme) ValueError: min or max of an empty ndarray"));
+    }
+    if (a->buf->dtype == NDARRAY_FLOAT64) {
+        return vm_create_numericObj(vm_api_stat_mind(ndarray_d(a), a->len, max));
+    }
+    v = ndarray_l(a);
+    r = v[0];
+    for (i = 1; i < a->len; i++) {
+        if (max ? v[i] > r : v[i] < r) { r = v[i]; }
+    }
+    return vm_create_numericObj(r);
+}
+
+static type_vmObj ndarray_min(type_vm *tp) { return ndarray_extreme(tp, 0); }
+static type_vmObj ndarray_max(type_vm *tp) { return ndarray_extreme(tp, 1); }
+
+static type_vmObj ndarray_dot(type_vm *tp) {
+    ndarray_array *a = ndarray_self(tp);
+    type_vmObj o = vm_operations_get(tp, tp->params, vm_none);
+    ndarray_array *b;
+    if (!ndarray_is(o)) {
+        vm_raise(tp, vm_string("(ndarray_dot) TypeError: dot needs an ndarray"));
+    }
+    b = ndarray_of(o);
+    if (a->len != b->len) {
+        vm_raise(tp, vm_string("(ndarray_dot) ValueError: arrays differ in length"));
+    }
+    return vm_create_numericObj(vm_api_stat_dotd(ndarray_asd(tp, a), ndarray_asd(tp, b), a->len));
+}
+
+/*
+ * a.tolist() copies the elements into a packed list.
+ */
+static type_vmObj ndarray_tolist(type_vm *tp) {
+    ndarray_array *a = ndarray_self(tp);
+    type_vmObj r = vm_list_packed(tp, a->len);
+    if (a->len) { memcpy(r.list.val->nums, ndarray_asd(tp, a), a->len * sizeof(type_vmNum)); }
+    return r;
+}
+
+static type_vmObj ndarray_copy(type_vm *tp) {
+    ndarray_array *a = ndarray_self(tp);
+    type_vmObj r = ndarray_new(tp, a->buf->dtype, a->len);
+    size_t size = a->buf->dtype == NDARRAY_INT64 ? sizeof(long) : sizeof(double);
+    if (a->len) { memcpy(ndarray_of(r)->buf->v, (char *)a->buf->v + a->off * size, a->len * size); }
+    return r;
+}
+
+static type_vmObj ndarray_fill(type_vm *tp) {
+    ndarray_array *a = ndarray_self(tp);
+    double v = vm_typecheck(tp, vm_enum1_number, vm_operations_get(tp, tp->params, vm_none)).number.val;
+    int i;
+    for (i = 0; i < a->len; i++) { ndarray_put(a, i, v); }
+    return vm_none;
+}
+
+static type_vmObj ndarray_get(type_vm *tp, type_vmObj self, type_vmObj k) {
+    ndarray_array *a = ndarray_of(self);
+    if (k.type == vm_enum1_number) {
+        return vm_create_numericObj(ndarray_at(a, ndarray_index(tp, a, k)));
+    } else if (k.type == vm_enum1_list) {
+        type_vmObj x = vm_operations_get(tp, k, vm_create_numericObj(0));
+        type_vmObj y = vm_operations_get(tp, k, vm_create_numericObj(1));
+        int l = a->len;
+        int s = x.type == vm_enum1_none ? 0 : vm_typecheck(tp, vm_enum1_number, x).number.val;
+        int e = y.type == vm_enum1_none ? l : vm_typecheck(tp, vm_enum1_number, y).number.val;
+        s = vm_max(0, (s < 0 ? l + s : s)); e = vm_min(l, (e < 0 ? l + e : e));
+        return ndarray_view(tp, a->buf, a->off + vm_min(s, l), vm_max(0, e - s));
+    } else if (k.type == vm_enum1_string) {
+        if (vm_operations_cmp(tp, vm_string("dtype"), k) == 0) {
+            return vm_string(a->buf->dtype == NDARRAY_INT64 ? "int64" : "float64");
+        } else if (vm_operations_cmp(tp, vm_string("sum"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_sum);
+        } else if (vm_operations_cmp(tp, vm_string("mean"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_mean);
+        } else if (vm_operations_cmp(tp, vm_string("min"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_min);
+        } else if (vm_operations_cmp(tp, vm_string("max"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_max);
+        } else if (vm_operations_cmp(tp, vm_string("dot"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_dot);
+        } else if (vm_operations_cmp(tp, vm_string("tolist"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_tolist);
+        } else if (vm_operations_cmp(tp, vm_string("copy"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_copy);
+        } else if (vm_operations_cmp(tp, vm_string("fill"), k) == 0) {
+            return vm_misc_method(tp, self, ndarray_fill);
+        }
+    }
+    vm_raise(tp, vm_string("(ndarray_get) KeyError"));
+    return vm_none;
+}
+
+static void ndarray_set(type_vm *tp, type_vmObj self, type_vmObj k, type_vmObj v) {
+    ndarray_array *a = ndarray_of(self);
+    ndarray_put(a, ndarray_index(tp, a, k), vm_typecheck(tp, vm_enum1_number, v).number.val);
+}
+
+static type_vmObj ndarray_len(type_vm *tp, type_vmObj self) {
+    return vm_create_numericObj(ndarray_of(self)->len);
+}
+
+static type_vmObj ndarray_str(type_vm *tp, type_vmObj self) {
+    ndarray_array *a = ndarray_of(self);
+    return vm_string_printf(tp, "<ndarray %s %d>",
+        a->buf->dtype == NDARRAY_INT64 ? "int64" : "float64", a->len);
+}
+
+static void ndarray_free(type_vm *tp, type_vmObj self) {
+    ndarray_array *a = ndarray_of(self);
+    if (--a->buf->refs == 0) {
+        free(a->buf->v);
+        free(a->buf);
+    }
+    free(a);
+}
+
+/*
+ * an array for buf[off..off+len), sharing buf.
+ */
+static type_vmObj ndarray_view(type_vm *tp, ndarray_buffer *buf, int off, int len) {
+    ndarray_array *a = (ndarray_array *)calloc(sizeof(ndarray_array), 1);/*calloc((x),1)*/
+    type_vmObj r;
+    buf->refs += 1;
+    a->buf = buf;
+    a->off = off;
+    a->len = len;
+    r = vm_misc_dataObj(tp, vm_enum3_ndarray, a);
+    r.data.info->free = ndarray_free;
+    r.data.info->get = ndarray_get;
+    r.data.info->set = ndarray_set;
+    r.data.info->len = ndarray_len;
+    r.data.info->str = ndarray_str;
+    r.data.info->arith = ndarray_arith;
+    return r;
+}
+
+/*
+ * ndarray.array(seq[, dtype]) copies a list, ndarray or
+ * other sequence of numbers into a new array.
+ */
+static type_vmObj ndarray_array_new(type_vm *tp) {
+    type_vmObj v = vm_operations_get(tp, tp->params, vm_none);
+    int dtype = ndarray_dtype(tp);
+    int n = vm_operations_len(tp, v).number.val, i;
+    type_vmObj r = ndarray_new(tp, dtype, n);
+    ndarray_array *a = ndarray_of(r);
+    if (v.type == vm_enum1_list && v.list.val->nums && dtype == NDARRAY_FLOAT64) {
+        if (n) { memcpy(ndarray_d(a), v.list.val->nums, n * sizeof(double)); }
+        return r;
+    }
+    for (i = 0; i < n; i++) {
+        type_vmObj e = v.type == vm_enum1_list ? vm_list_at(v.list.val, i) :
+            vm_operations_get(tp, v, vm_create_numericObj(i));
+        ndarray_put(a, i, vm_typecheck(tp, vm_enum1_number, e).number.val);
+    }
+    return r;
+}
+
+/*
+ * ndarray.zeros(n[, dtype]) is an array of n zeros.
+ */
+static type_vmObj ndarray_zeros(type_vm *tp) {
+    int n = vm_max(0, (int)vm_typecheck(tp, vm_enum1_number, vm_operations_get(tp, tp->params, vm_none)).number.val);
+    int dtype = ndarray_dtype(tp);
+    type_vmObj r = ndarray_new(tp, dtype, n);
+    if (n) { memset(ndarray_of(r)->buf->v, 0, n * (dtype == NDARRAY_INT64 ? sizeof(long) : sizeof(double))); }
+    return r;
+}
+
+/*
+ * ndarray.arange(n[, dtype]) is the array 0, 1, ... n-1.
+ */
+static type_vmObj ndarray_arange(type_vm *tp) {
+    int n = vm_max(0, (int)vm_typecheck(tp, vm_enum1_number, vm_operations_get(tp, tp->params, vm_none)).number.val);
+    type_vmObj r = ndarray_new(tp, ndarray_dtype(tp), n);
+    int i;
+    for (i = 0; i < n; i++) { ndarray_put(ndarray_of(r), i, i); }
+    return r;
+}
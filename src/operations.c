@@ -11,9 +11,7 @@ type_vmObj vm_operations_str(type_vm *tp,type_vmObj self) {
     int type = self.type;
     if (type == vm_enum1_string) { return self; }
     if (type == vm_enum1_number) {
-        type_vmNum v = self.number.val;
-        if ((fabs(v)-fabs((long)v)) < 0.000001) { return vm_string_printf(tp,"%ld",(long)v); }
-        return vm_string_printf(tp,"%f",v);
+        return vm_string_number(tp,self.number.val);
     } else if(type == vm_enum1_dict) {
         return vm_string_printf(tp,"<dict 0x%x>",self.dict.val);
     } else if(type == vm_enum1_list) {
@@ -21,6 +19,7 @@ type_vmObj vm_operations_str(type_vm *tp,type_vmObj self) {
     } else if (type == vm_enum1_none) {
         return vm_string("None");
     } else if (type == vm_enum1_data) {
+        if (self.data.info->str) { return self.data.info->str(tp,self); }
         return vm_string_printf(tp,"<data 0x%x>",self.data.val);
     } else if (type == vm_enum1_fnc) {
         return vm_string_printf(tp,"<fnc 0x%x>",self.fnc.info);
@@ -61,6 +60,8 @@ type_vmObj vm_operations_haskey(type_vm *tp,type_vmObj self, type_vmObj k) {
         return vm_create_numericObj(vm_string_index(self,k)!=-1);
     } else if (type == vm_enum1_list) {
         return vm_create_numericObj(vm_list_find(tp,self.list.val,k)!=-1);
+    } else if (type == vm_enum1_data && self.data.info->has) {
+        return vm_create_numericObj(self.data.info->has(tp,self,k));
     }
     vm_raise(0,vm_string("(vm_operations_haskey) TypeError: iterable argument required"));
 	return vm_none;
@@ -91,10 +92,8 @@ void vm_operations_dict_key_del(type_vm *tp,type_vmObj self, type_vmObj k) {
  * starting with 0 up to the length of the object-1.
  *
  * In the case of a list of string, the returned items will correspond to the
- * item at index k. For a dictionary, no guarantees are made about the order.
- * You also cannot call the function with a specific k to get a specific
- * item -- it is only meant for iterating through all items, calling this
- * function len(self) times. Use <vm_operations_get> to retrieve a specific item, and
+ * item at index k. For a dictionary, keys are returned in insertion order.
+ * Use <vm_operations_get> to retrieve a specific item, and
  * <vm_operations_len> to get the length.
  *
  * Parameters:
@@ -109,13 +108,62 @@ type_vmObj vm_operations_iterate(type_vm *tp,type_vmObj self, type_vmObj k) {
     int type = self.type;
     if (type == vm_enum1_list || type == vm_enum1_string) { return vm_operations_get(tp,self,k); }
     if (type == vm_enum1_dict && k.type == vm_enum1_number) {
-        return self.dict.val->items[vm_dict_next(tp,self.dict.val)].key;
+        return self.dict.val->items[vm_dict_at(tp,self.dict.val,k.number.val)].key;
     }
+    if (type == vm_enum1_data && self.data.info->get) { return self.data.info->get(tp,self,k); }
     vm_raise(0,vm_string("(vm_operations_iterate) TypeError: iteration over non-sequence"));
 	return vm_none;
 }
 
 
+/* Function: vm_operations_step
+ * self[a:b:step] for a list self of length l, with k holding a and b.
+ *
+ * As in Python, a and b default to the ends the step runs from and to.
+ */
+static type_vmObj vm_operations_step(type_vm *tp,type_vmObj self, type_vmObj k, int l, int step) {
+    type_vmObj x = vm_operations_get(tp,k,vm_create_numericObj(0));
+    type_vmObj y = vm_operations_get(tp,k,vm_create_numericObj(1));
+    int a, b, n;
+    if (step == 0) {
+        vm_raise(tp,vm_string("(vm_operations_step) ValueError: slice step cannot be zero"));
+    }
+    if (x.type == vm_enum1_none) { a = step > 0 ? 0 : l-1; }
+    else {
+        a = vm_typecheck(tp,vm_enum1_number,x).number.val;
+        a = a < 0 ? vm_max(a+l,step > 0 ? 0 : -1) : vm_min(a,step > 0 ? l : l-1);
+    }
+    if (y.type == vm_enum1_none) { b = step > 0 ? l : -1; }
+    else {
+        b = vm_typecheck(tp,vm_enum1_number,y).number.val;
+        b = b < 0 ? vm_max(b+l,step > 0 ? 0 : -1) : vm_min(b,step > 0 ? l : l-1);
+    }
+    if (step > 0) { n = b > a ? (b-a+step-1)/step : 0; }
+    else { n = a > b ? (a-b-step-1)/(-step) : 0; }
+    return vm_list_step(tp,self.list.val,a,step,n);
+}
+
+/* The method k of a plain dict, or none. Keys stored in the dict come
+ * first, so d["items"] still finds an entry called items. */
+static type_vmObj vm_operations_dict_method(type_vm *tp,type_vmObj self, type_vmObj k) {
+    if (vm_operations_cmp(tp,vm_string("keys"),k) == 0) {
+        return vm_misc_method(tp,self,vm_dict_keys);
+    } else if (vm_operations_cmp(tp,vm_string("values"),k) == 0) {
+        return vm_misc_method(tp,self,vm_dict_values);
+    } else if (vm_operations_cmp(tp,vm_string("items"),k) == 0) {
+        return vm_misc_method(tp,self,vm_dict_items);
+    } else if (vm_operations_cmp(tp,vm_string("get"),k) == 0) {
+        return vm_misc_method(tp,self,vm_dict_get2);
+    } else if (vm_operations_cmp(tp,vm_string("setdefault"),k) == 0) {
+        return vm_misc_method(tp,self,vm_dict_setdefault);
+    } else if (vm_operations_cmp(tp,vm_string("pop"),k) == 0) {
+        return vm_misc_method(tp,self,vm_dict_pop);
+    } else if (vm_operations_cmp(tp,vm_string("update"),k) == 0) {
+        return vm_misc_method(tp,self,vm_dict_update);
+    }
+    return vm_none;
+}
+
 /* Function: vm_operations_get
  * Attribute lookup.
  * 
@@ -136,6 +184,10 @@ type_vmObj vm_operations_get(type_vm *tp,type_vmObj self, type_vmObj k) {
 						}			
 			}
         if (self.dict.dtype && vm_api_lookup(tp,self,k,&r)) { return r; }
+        if (self.dict.dtype == 1 && k.type == vm_enum1_string) {
+            r = vm_operations_dict_method(tp,self,k);
+            if (r.type == vm_enum1_fnc) { return r; }
+        }
         return vm_dict_get(tp,self.dict.val,k,"vm_operations_get");
     } else if (type == vm_enum1_list) {
         if (k.type == vm_enum1_number) {
@@ -148,6 +200,8 @@ type_vmObj vm_operations_get(type_vm *tp,type_vmObj self, type_vmObj k) {
                 return vm_misc_method(tp,self,vm_list_append2);
             } else if (vm_operations_cmp(tp,vm_string("pop"),k) == 0) {
                 return vm_misc_method(tp,self,vm_list_pop2);
+            } else if (vm_operations_cmp(tp,vm_string("insert"),k) == 0) {
+                return vm_misc_method(tp,self,vm_list_insert2);
             } else if (vm_operations_cmp(tp,vm_string("index"),k) == 0) {
                 return vm_misc_method(tp,self,vm_list_index);
             } else if (vm_operations_cmp(tp,vm_string("sort"),k) == 0) {
@@ -176,12 +230,40 @@ type_vmObj vm_operations_get(type_vm *tp,type_vmObj self, type_vmObj k) {
                 return vm_misc_method(tp,self,vm_string_split);
             } else if (vm_operations_cmp(tp,vm_string("index"),k) == 0) {
                 return vm_misc_method(tp,self,vm_string_obj_index);
+            } else if (vm_operations_cmp(tp,vm_string("find"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_find);
             } else if (vm_operations_cmp(tp,vm_string("strip"),k) == 0) {
                 return vm_misc_method(tp,self,vm_string_strip);
             } else if (vm_operations_cmp(tp,vm_string("replace"),k) == 0) {
                 return vm_misc_method(tp,self,vm_string_replace);
+            } else if (vm_operations_cmp(tp,vm_string("count"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_count);
+            } else if (vm_operations_cmp(tp,vm_string("lower"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_lower);
+            } else if (vm_operations_cmp(tp,vm_string("upper"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_upper);
+            } else if (vm_operations_cmp(tp,vm_string("translate"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_translate);
+            } else if (vm_operations_cmp(tp,vm_string("isspace"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_isspace);
+            } else if (vm_operations_cmp(tp,vm_string("isdigit"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_isdigit);
+            } else if (vm_operations_cmp(tp,vm_string("isalpha"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_isalpha);
+            } else if (vm_operations_cmp(tp,vm_string("ulen"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_ulen2);
+            } else if (vm_operations_cmp(tp,vm_string("uat"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_uat);
+            } else if (vm_operations_cmp(tp,vm_string("uslice"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_uslice);
+            } else if (vm_operations_cmp(tp,vm_string("uchars"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_uchars);
+            } else if (vm_operations_cmp(tp,vm_string("isutf8"),k) == 0) {
+                return vm_misc_method(tp,self,vm_string_isutf8);
             }
         }
+    } else if (type == vm_enum1_data && self.data.info->get) {
+        return self.data.info->get(tp,self,k);
     }
 
     if (k.type == vm_enum1_list) {
@@ -196,9 +278,15 @@ type_vmObj vm_operations_get(type_vm *tp,type_vmObj self, type_vmObj k) {
         if (tmp.type == vm_enum1_number) { b = tmp.number.val; }
         else if(tmp.type == vm_enum1_none) { b = l; }
         else { vm_raise(0,vm_string("(vm_operations_get) TypeError: indices must be numbers")); }
+        if (type == vm_enum1_list && k.list.val->len > 2) {
+            tmp = vm_operations_get(tp,k,vm_create_numericObj(2));
+            if (tmp.type != vm_enum1_none && vm_typecheck(tp,vm_enum1_number,tmp).number.val != 1) {
+                return vm_operations_step(tp,self,k,l,tmp.number.val);
+            }
+        }
         a = vm_max(0,(a<0?l+a:a)); b = vm_min(l,(b<0?l+b:b));
         if (type == vm_enum1_list) {
-            return vm_list_n(tp,b-a,&self.list.val->items[a]);
+            return vm_list_slice(tp,self.list.val,a,b);
         } else if (type == vm_enum1_string) {
             return vm_string_substring(tp,self,a,b);
         }
@@ -260,27 +348,35 @@ void vm_operations_set(type_vm *tp,type_vmObj self, type_vmObj k, type_vmObj v)
                 return;
             }
         }
+    } else if (type == vm_enum1_data && self.data.info->set) {
+        self.data.info->set(tp,self,k,v);
+        return;
     }
     vm_raise(tp,vm_string("(vm_operations_set) TypeError: object does not support item assignment"));
 }
 
+/* The data object among a and b that handles a op b, see <vm_type_data>. */
+vm_inline static vm_type_data *vm_operations_arith(type_vmObj a, type_vmObj b) {
+    if (a.type == vm_enum1_data && a.data.info->arith) { return a.data.info; }
+    if (b.type == vm_enum1_data && b.data.info->arith) { return b.data.info; }
+    return 0;
+}
+
 type_vmObj vm_operations_add(type_vm *tp,type_vmObj a, type_vmObj b) {
     if (a.type == vm_enum1_number && a.type == b.type) {
         return vm_create_numericObj(a.number.val+b.number.val);
     } else if (a.type == vm_enum1_string && a.type == b.type) {
-        int al = a.string.len, bl = b.string.len;
-        type_vmObj r = vm_string_new(tp,al+bl);
-        char *s = r.string.info->s;
-        memcpy(s,a.string.val,al); memcpy(s+al,b.string.val,bl);
-        return vm_gc_track(tp,r);
+        return vm_string_concat(tp,a,b);
     } else if (a.type == vm_enum1_list && a.type == b.type) {
-        type_vmObj r;
-        vm_misc_params_v(tp,1,a);
-        r = vm_api_copy(tp);
-        vm_misc_params_v(tp,2,r,b);
-        vm_list_extend(tp);
+        type_vmObj r = vm_list(tp);
+        vm_list_realloc(tp,r.list.val,a.list.val->len+b.list.val->len);
+        vm_list_extend_sub(tp,r.list.val,a.list.val);
+        vm_list_extend_sub(tp,r.list.val,b.list.val);
         return r;
     }
+    if (vm_operations_arith(a,b)) {
+        return vm_operations_arith(a,b)->arith(tp,vm_enum2_ADD,a,b);
+    }
     vm_raise(0,vm_string("(vm_operations_add) TypeError: ?"));
 	return vm_none;
 }
@@ -303,6 +399,9 @@ type_vmObj vm_operations_mul(type_vm *tp,type_vmObj a, type_vmObj b) {
         int i; for (i=0; i<n; i++) { memcpy(s+al*i,a.string.val,al); }
         return vm_gc_track(tp,r);
     }
+    if (vm_operations_arith(a,b)) {
+        return vm_operations_arith(a,b)->arith(tp,vm_enum2_MUL,a,b);
+    }
     vm_raise(0,vm_string("(vm_operations_mul) TypeError: ?"));
 	return vm_none;
 }
@@ -320,6 +419,8 @@ type_vmObj vm_operations_len(type_vm *tp,type_vmObj self) {
         return vm_create_numericObj(self.dict.val->len);
     } else if (type == vm_enum1_list) {
         return vm_create_numericObj(self.list.val->len);
+    } else if (type == vm_enum1_data && self.data.info->len) {
+        return self.data.info->len(tp,self);
     }
     
     vm_raise(0,vm_string("(vm_operations_len) TypeError: len() of unsized object"));
@@ -341,13 +442,13 @@ int vm_operations_cmp(type_vm *tp,type_vmObj a, type_vmObj b) {
         }
         case vm_enum1_list: {
             int n,v; for(n=0;n<vm_min(a.list.val->len,b.list.val->len);n++) {
-        type_vmObj aa = a.list.val->items[n]; type_vmObj bb = b.list.val->items[n];
+        type_vmObj aa = vm_list_at(a.list.val,n); type_vmObj bb = vm_list_at(b.list.val,n);
             if (aa.type == vm_enum1_list && bb.type == vm_enum1_list) { v = aa.list.val-bb.list.val; } else { v = vm_operations_cmp(tp,aa,bb); }
             if (v) { return v; } }
             return a.list.val->len-b.list.val->len;
         }
         case vm_enum1_dict: return a.dict.val - b.dict.val;
-        case vm_enum1_fnc: return a.fnc.info - b.fnc.info;
+        case vm_enum1_fnc: return a.fnc.info != b.fnc.info ? a.fnc.info - b.fnc.info : (char*)a.fnc.cfnc - (char*)b.fnc.cfnc;
         case vm_enum1_data: return (char*)a.data.val - (char*)b.data.val;
     }
     vm_raise(0,vm_string("(vm_operations_cmp) TypeError: ?"));
@@ -360,6 +461,9 @@ type_vmObj vm_operations_bitwise_and(type_vm *tp,type_vmObj _a,type_vmObj _b)
 	    if (_a.type == vm_enum1_number && _a.type == _b.type) { 
         type_vmNum a = _a.number.val; type_vmNum b = _b.number.val; 
         return vm_create_numericObj(((long)a)&((long)b)); 
+    }
+    if (vm_operations_arith(_a,_b)) {
+        return vm_operations_arith(_a,_b)->arith(tp,vm_enum2_BITAND,_a,_b);
     }
 	return vm_none;
 } /* interpreter_OP(vm_operations_bitwise_and,((long)a)&((long)b)); */
@@ -368,6 +472,9 @@ type_vmObj vm_operations_bitwise_or(type_vm *tp,type_vmObj _a,type_vmObj _b)
 	    if (_a.type == vm_enum1_number && _a.type == _b.type) { 
         type_vmNum a = _a.number.val; type_vmNum b = _b.number.val; 
         return vm_create_numericObj(((long)a)|((long)b)); 
+    }
+    if (vm_operations_arith(_a,_b)) {
+        return vm_operations_arith(_a,_b)->arith(tp,vm_enum2_BITOR,_a,_b);
     }
 	return vm_none;
 }
@@ -376,6 +483,9 @@ type_vmObj vm_operations_bitwise_xor(type_vm *tp,type_vmObj _a,type_vmObj _b)
 	    if (_a.type == vm_enum1_number && _a.type == _b.type) { 
         type_vmNum a = _a.number.val; type_vmNum b = _b.number.val; 
         return vm_create_numericObj(((long)a)^((long)b)); 
+    }
+    if (vm_operations_arith(_a,_b)) {
+        return vm_operations_arith(_a,_b)->arith(tp,vm_enum2_BITXOR,_a,_b);
     }
 	return vm_none;
 }
@@ -408,6 +518,9 @@ type_vmObj vm_operations_sub(type_vm *tp,type_vmObj _a,type_vmObj _b)
 	    if (_a.type == vm_enum1_number && _a.type == _b.type) { 
         type_vmNum a = _a.number.val; type_vmNum b = _b.number.val; 
         return vm_create_numericObj(a-b); 
+    }
+    if (vm_operations_arith(_a,_b)) {
+        return vm_operations_arith(_a,_b)->arith(tp,vm_enum2_SUB,_a,_b);
     }
 	return vm_none;
 }
@@ -416,6 +529,9 @@ type_vmObj vm_operations_div(type_vm *tp,type_vmObj _a,type_vmObj _b)
 	    if (_a.type == vm_enum1_number && _a.type == _b.type) { 
         type_vmNum a = _a.number.val; type_vmNum b = _b.number.val; 
         return vm_create_numericObj(a/b); 
+    }
+    if (vm_operations_arith(_a,_b)) {
+        return vm_operations_arith(_a,_b)->arith(tp,vm_enum2_DIV,_a,_b);
     }
 	return vm_none;
 }
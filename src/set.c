@@ -0,0 +1,241 @@
+/* File: Set
+ * Sets returned by set().
+ *
+ * A set is a <type_vmDict> whose entries hold the members as keys, so
+ * membership is one hashed probe instead of the scan `in` does on a list.
+ * The values of the entries are unused and stay none.
+ */
+
+vm_inline static type_vmDict *vm_set_of(type_vmObj self) {
+    return (type_vmDict*)self.data.val;
+}
+
+vm_inline static type_vmDict *vm_set_self(type_vm *tp) {
+    return vm_set_of(vm_operations_get(tp,tp->params,vm_none));
+}
+
+vm_inline static int vm_set_is(type_vmObj v) {
+    return v.type == vm_enum1_data && v.data.magic == vm_enum3_set;
+}
+
+type_vmObj vm_set_create(type_vm *tp);
+
+void vm_set_add(type_vm *tp, type_vmDict *self, type_vmObj k) {
+    vm_dict_setx_sub(tp,self,k,vm_none);
+    vm_gc_grey(tp,k);
+}
+
+/* Makes room for n more members, so adding them never resizes. */
+static void vm_set_reserve(type_vm *tp, type_vmDict *self, int n) {
+    if (self->used+n > self->alloc) { vm_dict_realloc_sub(tp,self,self->len+n); }
+}
+
+/* Adds the members of o, reusing the hashes stored with them. */
+static void vm_set_merge(type_vm *tp, type_vmDict *self, type_vmDict *o) {
+    int i;
+    vm_set_reserve(tp,self,o->len);
+    for (i=0; i<o->used; i++) {
+        type_vmItem *e = &o->items[i];
+        if (e->used && vm_dict_hash_find_sub(tp,self,e->hash,e->key) < 0) {
+            vm_dict_hash_set_sub(tp,self,e->hash,e->key,vm_none);
+            vm_gc_grey(tp,e->key);
+        }
+    }
+}
+
+/* Adds the members of a set, or the items of anything iterable. */
+static void vm_set_update_sub(type_vm *tp, type_vmDict *self, type_vmObj v) {
+    int n, i;
+    if (vm_set_is(v)) {
+        vm_set_merge(tp,self,vm_set_of(v));
+        return;
+    }
+    n = vm_operations_len(tp,v).number.val;
+    vm_set_reserve(tp,self,n);
+    for (i=0; i<n; i++) { vm_set_add(tp,self,vm_operations_iterate(tp,v,vm_create_numericObj(i))); }
+}
+
+/* The members of a that are in b, or that are not in b if out is set. */
+static type_vmObj vm_set_filter(type_vm *tp, type_vmDict *a, type_vmDict *b, int out) {
+    type_vmObj r = vm_set_create(tp);
+    int i;
+    for (i=0; i<a->used; i++) {
+        type_vmItem *e = &a->items[i];
+        if (e->used && (vm_dict_hash_find_sub(tp,b,e->hash,e->key) < 0) == out) {
+            vm_set_add(tp,vm_set_of(r),e->key);
+        }
+    }
+    return r;
+}
+
+/* The set operand of a method or operator. */
+static type_vmDict *vm_set_arg(type_vm *tp, type_vmObj v) {
+    if (!vm_set_is(v)) {
+        vm_raise(tp,vm_string("(vm_set_arg) TypeError: expected a set"));
+    }
+    return vm_set_of(v);
+}
+
+type_vmObj vm_set_add2(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    vm_set_add(tp,self,vm_operations_get(tp,tp->params,vm_none));
+    return vm_none;
+}
+
+type_vmObj vm_set_remove(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    vm_dict_del(tp,self,vm_operations_get(tp,tp->params,vm_none),"vm_set_remove");
+    return vm_none;
+}
+
+type_vmObj vm_set_discard(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    type_vmObj k = vm_operations_get(tp,tp->params,vm_none);
+    if (vm_dict_find_sub(tp,self,k) >= 0) { vm_dict_del(tp,self,k,"vm_set_discard"); }
+    return vm_none;
+}
+
+type_vmObj vm_set_clear(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    free(self->items);
+    free(self->index);
+    self->items = 0;
+    self->index = 0;
+    self->len = self->alloc = self->used = self->mask = 0;
+    return vm_none;
+}
+
+type_vmObj vm_set_update(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    vm_set_update_sub(tp,self,vm_operations_get(tp,tp->params,vm_none));
+    return vm_none;
+}
+
+type_vmObj vm_set_copy(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    type_vmObj r = vm_set_create(tp);
+    vm_set_merge(tp,vm_set_of(r),self);
+    return r;
+}
+
+type_vmObj vm_set_union(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    type_vmObj r = vm_set_create(tp);
+    vm_set_merge(tp,vm_set_of(r),self);
+    vm_set_update_sub(tp,vm_set_of(r),vm_operations_get(tp,tp->params,vm_none));
+    return r;
+}
+
+type_vmObj vm_set_intersection(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    type_vmDict *o = vm_set_arg(tp,vm_operations_get(tp,tp->params,vm_none));
+    return self->len <= o->len ? vm_set_filter(tp,self,o,0) : vm_set_filter(tp,o,self,0);
+}
+
+type_vmObj vm_set_difference(type_vm *tp) {
+    type_vmDict *self = vm_set_self(tp);
+    return vm_set_filter(tp,self,vm_set_arg(tp,vm_operations_get(tp,tp->params,vm_none)),1);
+}
+
+type_vmObj vm_set_get(type_vm *tp, type_vmObj self, type_vmObj k) {
+    type_vmDict *d = vm_set_of(self);
+    if (k.type == vm_enum1_number) {
+        return d->items[vm_dict_at(tp,d,k.number.val)].key;
+    } else if (k.type == vm_enum1_string) {
+        if (vm_operations_cmp(tp,vm_string("add"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_add2);
+        } else if (vm_operations_cmp(tp,vm_string("remove"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_remove);
+        } else if (vm_operations_cmp(tp,vm_string("discard"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_discard);
+        } else if (vm_operations_cmp(tp,vm_string("clear"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_clear);
+        } else if (vm_operations_cmp(tp,vm_string("update"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_update);
+        } else if (vm_operations_cmp(tp,vm_string("copy"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_copy);
+        } else if (vm_operations_cmp(tp,vm_string("union"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_union);
+        } else if (vm_operations_cmp(tp,vm_string("intersection"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_intersection);
+        } else if (vm_operations_cmp(tp,vm_string("difference"),k) == 0) {
+            return vm_misc_method(tp,self,vm_set_difference);
+        }
+    }
+    vm_raise(tp,vm_string("(vm_set_get) KeyError"));
+    return vm_none;
+}
+
+int vm_set_has(type_vm *tp, type_vmObj self, type_vmObj k) {
+    return vm_dict_find_sub(tp,vm_set_of(self),k) >= 0;
+}
+
+/* a | b, a & b, a - b and a ^ b of two sets. */
+type_vmObj vm_set_arith(type_vm *tp, int op, type_vmObj a, type_vmObj b) {
+    type_vmDict *x = vm_set_arg(tp,a), *y = vm_set_arg(tp,b);
+    type_vmObj r;
+    switch (op) {
+        case vm_enum2_BITOR:
+            r = vm_set_create(tp);
+            vm_set_reserve(tp,vm_set_of(r),x->len+y->len);
+            vm_set_merge(tp,vm_set_of(r),x);
+            vm_set_merge(tp,vm_set_of(r),y);
+            return r;
+        case vm_enum2_BITAND:
+            return x->len <= y->len ? vm_set_filter(tp,x,y,0) : vm_set_filter(tp,y,x,0);
+        case vm_enum2_SUB:
+            return vm_set_filter(tp,x,y,1);
+        case vm_enum2_BITXOR:
+            r = vm_set_filter(tp,x,y,1);
+            vm_set_merge(tp,vm_set_of(r),vm_set_of(vm_set_filter(tp,y,x,1)));
+            return r;
+    }
+    vm_raise(tp,vm_string("(vm_set_arith) TypeError: unsupported operand for set"));
+    return vm_none;
+}
+
+type_vmObj vm_set_len(type_vm *tp, type_vmObj self) {
+    return vm_create_numericObj(vm_set_of(self)->len);
+}
+
+type_vmObj vm_set_str(type_vm *tp, type_vmObj self) {
+    return vm_string_printf(tp,"<set %d>",vm_set_of(self)->len);
+}
+
+void vm_set_follow(type_vm *tp, type_vmObj self) {
+    type_vmDict *d = vm_set_of(self);
+    int n;
+    for (n=0; n<d->used; n++) {
+        if (d->items[n].used) { vm_gc_grey(tp,d->items[n].key); }
+    }
+}
+
+void vm_set_free(type_vm *tp, type_vmObj self) {
+    vm_dict_free(tp,vm_set_of(self));
+}
+
+/* Function: vm_set_create
+ * Creates a new empty set.
+ */
+type_vmObj vm_set_create(type_vm *tp) {
+    type_vmObj r = vm_misc_dataObj(tp,vm_enum3_set,vm_dict_new(tp));
+    r.data.info->free = vm_set_free;
+    r.data.info->get = vm_set_get;
+    r.data.info->len = vm_set_len;
+    r.data.info->str = vm_set_str;
+    r.data.info->follow = vm_set_follow;
+    r.data.info->arith = vm_set_arith;
+    r.data.info->has = vm_set_has;
+    return r;
+}
+
+/* Function: vm_set_new
+ * set([items]) makes a new set, holding the items of a list, string, dict
+ * or set if given.
+ */
+type_vmObj vm_set_new(type_vm *tp) {
+    type_vmObj v = vm_macros_DEFAULT(vm_none);
+    type_vmObj r = vm_set_create(tp);
+    if (v.type != vm_enum1_none) { vm_set_update_sub(tp,vm_set_of(r),v); }
+    return r;
+}
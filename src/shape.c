@@ -0,0 +1,154 @@
+/* File: Shape
+ * Object shapes and the inline caches built on them.
+ */
+
+type_vmShape *vm_shape_new(type_vmShape *parent, int hash, char const *key, int klen) {
+    type_vmShape *self = (type_vmShape*)calloc(sizeof(type_vmShape),1);/*calloc((x),1)*/
+    self->parent = parent;
+    self->len = parent ? parent->len+1 : 0;
+    self->hash = hash;
+    self->klen = klen;
+    if (klen) {
+        self->key = (char*)malloc(klen);
+        memcpy(self->key,key,klen);
+    }
+    return self;
+}
+
+void vm_shape_free(type_vmShape *self) {
+    while (self) {
+        type_vmShape *next = self->next;
+        vm_shape_free(self->child);
+        free(self->key);
+        free(self);
+        self = next;
+    }
+}
+
+void vm_shape_init(type_vm *tp) {
+    tp->shapes = vm_shape_new(0,0,0,0);
+    tp->meta_epoch = 0;
+}
+
+void vm_shape_deinit(type_vm *tp) {
+    vm_shape_free(tp->shapes);
+}
+
+/* Function: vm_shape_add
+ * The shape reached from self by adding string key k.
+ *
+ * Returns 0 when k is not a string or the shape would get too long, after
+ * which the object is treated as a plain dict.
+ */
+type_vmShape *vm_shape_add(type_vmShape *self, int hash, type_vmObj k) {
+    type_vmShape *c;
+    if (k.type != vm_enum1_string || self->len >= vm_def_SHAPE_MAX) { return 0; }
+    for (c=self->child; c; c=c->next) {
+        if (c->hash == hash && c->klen == k.string.len &&
+            memcmp(c->key,k.string.val,c->klen) == 0) { return c; }
+    }
+    c = vm_shape_new(self,hash,k.string.val,k.string.len);
+    c->next = self->child;
+    self->child = c;
+    return c;
+}
+
+/* Function: vm_shape_meta
+ * Makes meta the meta of self.
+ *
+ * The first time a dict becomes a meta it is flagged so that changes to it
+ * invalidate the inline caches, see <vm_dict_setx_sub>.
+ */
+void vm_shape_meta(type_vm *tp, type_vmDict *self, type_vmObj meta) {
+    self->meta = meta;
+    if (meta.type == vm_enum1_dict && !meta.dict.val->ismeta) {
+        meta.dict.val->ismeta = 1;
+        tp->meta_epoch += 1;
+    }
+    tp->meta_epoch += self->ismeta;
+}
+
+vm_inline static type_vmCache *vm_shape_cache(type_vm *tp, type_vmCode *pc) {
+    return &tp->cache[(((size_t)pc)>>2)&(vm_def_CACHE-1)];
+}
+
+vm_inline static type_vmDict *vm_shape_metaof(type_vmDict *self) {
+    return self->meta.type == vm_enum1_dict ? self->meta.dict.val : 0;
+}
+
+/* True if entry n of self holds the string key k. */
+vm_inline static int vm_shape_keyis(type_vmDict *self, int n, type_vmObj k) {
+    type_vmObj key = self->items[n].key;
+    return key.string.len == k.string.len &&
+        memcmp(key.string.val,k.string.val,k.string.len) == 0;
+}
+
+/* True if the cache entry c proves that self[k] is entry c->slot. */
+vm_inline static int vm_shape_hit(type_vm *tp, type_vmCache *c, type_vmCode *pc, type_vmDict *self, type_vmObj k) {
+    return c->pc == pc && c->shape == self->shape &&
+        c->meta == vm_shape_metaof(self) && c->epoch == tp->meta_epoch &&
+        vm_shape_keyis(self,c->slot,k);
+}
+
+vm_inline static void vm_shape_fill(type_vm *tp, type_vmCache *c, type_vmCode *pc, type_vmDict *self, int n) {
+    c->pc = pc;
+    c->shape = self->shape;
+    c->meta = vm_shape_metaof(self);
+    c->epoch = tp->meta_epoch;
+    c->slot = n;
+}
+
+/* Function: vm_shape_get
+ * <vm_operations_get> with an inline cache for the GET at pc.
+ *
+ * When self is an object with a shape, k is one of its own keys and no
+ * __get__ is defined, the entry number is cached so the next GET on an
+ * object of the same shape is a guarded load.
+ */
+type_vmObj vm_shape_get(type_vm *tp, type_vmCode *pc, type_vmObj self, type_vmObj k) {
+    type_vmDict *d = self.dict.val;
+    type_vmCache *c;
+    type_vmObj meta;
+    int n;
+    if (self.type != vm_enum1_dict || self.dict.dtype != 2 || !d->shape || k.type != vm_enum1_string) {
+        return vm_operations_get(tp,self,k);
+    }
+    c = vm_shape_cache(tp,pc);
+    if (vm_shape_hit(tp,c,pc,d,k)) { return d->items[c->slot].val; }
+    n = vm_dict_find_sub(tp,d,k);
+    if (n < 0 || vm_api_lookup(tp,self,vm_string("__get__"),&meta)) {
+        return vm_operations_get(tp,self,k);
+    }
+    vm_shape_fill(tp,c,pc,d,n);
+    return d->items[n].val;
+}
+
+/* Function: vm_shape_set
+ * <vm_operations_set> with an inline cache for the SET at pc.
+ */
+void vm_shape_set(type_vm *tp, type_vmCode *pc, type_vmObj self, type_vmObj k, type_vmObj v) {
+    type_vmDict *d = self.dict.val;
+    type_vmCache *c;
+    type_vmObj meta;
+    int n;
+    if (self.type != vm_enum1_dict || self.dict.dtype != 2 || !d->shape || d->ismeta || k.type != vm_enum1_string) {
+        vm_operations_set(tp,self,k,v);
+        return;
+    }
+    c = vm_shape_cache(tp,pc);
+    if (vm_shape_hit(tp,c,pc,d,k)) {
+        d->items[c->slot].val = v;
+        vm_gc_grey(tp,v);
+        return;
+    }
+    if (vm_api_lookup(tp,self,vm_string("__set__"),&meta)) {
+        vm_call_sub(tp,meta,vm_misc_params_v(tp,2,k,v));
+        return;
+    }
+    vm_dict_set_sub(tp,d,k,v);
+    if (d->shape && (n = vm_dict_find_sub(tp,d,k)) >= 0) {
+        vm_shape_fill(tp,c,pc,d,n);
+    }
+}
+
+/**/
@@ -3,24 +3,36 @@
  */
  
 /*
- * Create a new empty string of a certain size.
+ * Create a new empty string of size n with room for alloc bytes.
  * Does not put it in for GC tracking, since contents should be
  * filled after returning.
  */ 
-type_vmObj vm_string_new(type_vm *tp, int n) {
+type_vmObj vm_string_alloc(type_vm *tp, int n, int alloc) {
     type_vmObj r = vm_string_n(0,n);
-    r.string.info = (type_vmString*)calloc(sizeof(type_vmString)+n,1);/*calloc((x),1)*/
+    r.string.info = (type_vmString*)calloc(sizeof(type_vmString)+alloc,1);/*calloc((x),1)*/
     r.string.info->len = n;
+    r.string.info->alloc = alloc;
     r.string.val = r.string.info->s;
     return r;
 }
 
+/*
+ * Create a new empty string of a certain size.
+ * Does not put it in for GC tracking, since contents should be
+ * filled after returning.
+ */ 
+type_vmObj vm_string_new(type_vm *tp, int n) {
+    return vm_string_alloc(tp,n,n);
+}
+
 /*
  * Create a new string which is a copy of some memory.
  * This is put into GC tracking for you.
  */
 type_vmObj vm_string_copy(type_vm *tp, const char *s, int n) {
-    type_vmObj r = vm_string_new(tp,n);
+    type_vmObj r;
+    if (n == 1) { return vm_string_n(tp->chars[(unsigned char)*s],1); }
+    r = vm_string_new(tp,n);
     memcpy(r.string.info->s,s,n);
     return vm_gc_track(tp,r);
 }
@@ -39,6 +51,146 @@ type_vmObj vm_string_substring(type_vm *tp, type_vmObj s, int a, int b) {
     return r;
 }
 
+/* Writes the decimal digits of n so that they end just before e. */
+static char *vm_string_digits(char *e, unsigned long n) {
+    do { *--e = (char)('0' + n%10); n /= 10; } while (n);
+    return e;
+}
+
+/* Fills tp->ints, which <vm_string_number> hands out for small integers. */
+void vm_string_init(type_vm *tp) {
+    int i;
+    for (i=0; i<vm_def_INTS; i++) {
+        char b[4], *e = b+4, *a = vm_string_digits(e,i);
+        memcpy(tp->ints[i],a,e-a);
+        tp->ints[i][e-a] = 0;
+    }
+}
+
+/* Writes "%f" of v, finite and below 1e15, so that it ends just before e.
+ * The six decimals come from one product, which is off by far less than
+ * 1e-6; when that leaves the seventh decimal too close to a tie to tell which
+ * way sprintf would round, 0 is returned instead. */
+static char *vm_string_fixed(char *e, type_vmNum v) {
+    type_vmNum a = fabs(v), i = floor(a), t = (a-i)*1000000.0, f = floor(t);
+    unsigned long u = (unsigned long)i, d = (unsigned long)f;
+    int k;
+    if (fabs(t-f-0.5) < 0.000001) { return 0; }
+    if (t-f > 0.5) { d += 1; }
+    if (d == 1000000) { d = 0; u += 1; }
+    for (k=0; k<6; k++) { *--e = (char)('0' + d%10); d /= 10; }
+    *--e = '.';
+    e = vm_string_digits(e,u);
+    if (v < 0) { *--e = '-'; }
+    return e;
+}
+
+/* Copies a short string through tp->strs, a direct mapped cache keyed on
+ * its bytes, so a number formatted again reuses the string made last time.
+ * The new string is greyed as it is tracked, which covers the store. */
+static type_vmObj vm_string_cached(type_vm *tp, const char *s, int n) {
+    unsigned int h = 2166136261u;
+    type_vmObj *c;
+    int i;
+    for (i=0; i<n; i++) { h = (h ^ (unsigned char)s[i]) * 16777619u; }
+    c = &tp->strs[h%vm_def_STRS];
+    if (c->type == vm_enum1_string && c->string.len == n && !memcmp(c->string.val,s,n)) {
+        return *c;
+    }
+    return *c = vm_string_copy(tp,s,n);
+}
+
+/* Function: vm_string_number
+ * str() of a number.
+ *
+ * Integers are formatted by hand, and those below vm_def_INTS are views of
+ * tp->ints so they are not allocated at all. Other finite numbers below
+ * 1e15 are formatted by <vm_string_fixed>, falling back to sprintf only for
+ * the rest. Results that fit vm_def_STRS_LEN go through tp->strs.
+ */
+type_vmObj vm_string_number(type_vm *tp, type_vmNum v) {
+    char b[400], *e = b+sizeof(b), *a;
+    int len;
+    if ((fabs(v)-fabs((long)v)) < 0.000001) {
+        long n = (long)v;
+        if (n >= 0 && n < vm_def_INTS) {
+            return vm_string_n(tp->ints[n],n<10?1:n<100?2:n<1000?3:4);
+        }
+        a = vm_string_digits(e,n<0?0UL-(unsigned long)n:(unsigned long)n);
+        if (n < 0) { *--a = '-'; }
+    } else if (!(fabs(v) < 1e15) || !(a = vm_string_fixed(e,v))) {
+        a = b; e = b+sprintf(b,"%f",v);
+    }
+    len = e-a;
+    return len > vm_def_STRS_LEN ? vm_string_copy(tp,a,len) : vm_string_cached(tp,a,len);
+}
+
+/* Function: vm_string_shortest
+ * Writes the shortest "%g" form of v that reads back as v into b, which
+ * must hold 32 bytes, and returns its length.
+ */
+int vm_string_shortest(char *b, type_vmNum v) {
+    int p, l = 0;
+    for (p=15; p<=17; p++) {
+        l = sprintf(b,"%.*g",p,v);
+        if (v != v || strtod(b,0) == v) { break; }
+    }
+    return l;
+}
+
+static const double vm_string_pow10[] = {
+    1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+    1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22,
+};
+
+/* Function: vm_string_parse
+ * Fast path for reading a decimal number from s[0..n).
+ *
+ * Accepts [+-]digits[.digits][(e|E)[+-]digits] with at most 15
+ * significant digits and a decimal exponent within 22 of them. Then the
+ * digits and the power of ten are both exact doubles, so one multiply or
+ * divide rounds correctly (Clinger's fast path). Integers with a leading 0
+ * are left alone since strtol reads them as octal. Returns 0 when the
+ * caller must fall back to the C library.
+ */
+int vm_string_parse(char const *s, int n, type_vmNum *r) {
+    char const *e = s+n, *start;
+    type_vmNum m = 0;
+    int neg = 0, digits = 0, seen = 0, frac = 0, exp = 0, dot = 0;
+    if (s < e && (*s == '-' || *s == '+')) { neg = *s++ == '-'; }
+    start = s;
+    for (; s < e; s++) {
+        if ((unsigned char)(*s-'0') <= 9) {
+            if (m != 0 || *s != '0') { digits++; }
+            if (digits > 15) { return 0; }
+            m = m*10+(*s-'0');
+            frac += dot;
+            seen = 1;
+        } else if (*s == '.' && !dot) {
+            dot = 1;
+        } else {
+            break;
+        }
+    }
+    if (!seen) { return 0; }
+    if (s < e && (*s == 'e' || *s == 'E')) {
+        int eneg = 0, ed = 0;
+        dot = 1;
+        if (++s < e && (*s == '-' || *s == '+')) { eneg = *s++ == '-'; }
+        for (; s < e && (unsigned char)(*s-'0') <= 9; s++, ed++) {
+            if (exp < 1000) { exp = exp*10+(*s-'0'); }
+        }
+        if (!ed) { return 0; }
+        exp = eneg ? -exp : exp;
+    }
+    if (s != e || (!dot && *start == '0' && e-start > 1)) { return 0; }
+    exp -= frac;
+    if (exp < -22 || exp > 22) { return 0; }
+    m = exp < 0 ? m/vm_string_pow10[-exp] : m*vm_string_pow10[exp];
+    *r = neg ? -m : m;
+    return 1;
+}
+
 type_vmObj vm_string_printf(type_vm *tp, char const *fmt,...) {
     int l;
     type_vmObj r;
@@ -55,52 +207,474 @@ type_vmObj vm_string_printf(type_vm *tp, char const *fmt,...) {
     return vm_gc_track(tp,r);
 }
 
-int vm_string_index(type_vmObj s, type_vmObj k) {
-    int i=0;
-    while ((s.string.len - i) >= k.string.len) {
-        if (memcmp(s.string.val+i,k.string.val,k.string.len) == 0) {
-            return i;
+/* Concatenations at least this long get room to grow in place. */
+#define vm_def_CONCAT_MIN 128
+
+/* Function: vm_string_concat
+ * a + b for strings.
+ *
+ * Results of at least vm_def_CONCAT_MIN bytes are allocated with as much
+ * spare room again. When a ends exactly where the used part of its storage
+ * ends and b fits in the spare room, b is written there and the result is
+ * a longer view of the same storage. Bytes inside existing strings never
+ * change, so other views are unaffected, and a loop doing s = s + piece
+ * runs in linear time.
+ */
+type_vmObj vm_string_concat(type_vm *tp, type_vmObj a, type_vmObj b) {
+    type_vmString *info = a.string.info;
+    int al = a.string.len, bl = b.string.len;
+    type_vmObj r;
+    if (info && a.string.val+al == info->s+info->len && info->len+bl <= info->alloc) {
+        memcpy(info->s+info->len,b.string.val,bl);
+        info->len += bl;
+        a.string.len += bl;
+        vm_gc_grey(tp,a);
+        return a;
+    }
+    r = vm_string_alloc(tp,al+bl,(al+bl >= vm_def_CONCAT_MIN ? 2 : 1)*(al+bl));
+    memcpy(r.string.info->s,a.string.val,al);
+    memcpy(r.string.info->s+al,b.string.val,bl);
+    return vm_gc_track(tp,r);
+}
+
+/* Needles at least this long are searched with <vm_string_twoway>. */
+#define vm_def_TWOWAY_MIN 32
+
+/* Function: vm_string_twoway
+ * Two-Way (Crochemore-Perrin) search for long needles.
+ *
+ * Linear in the worst case and needs no memory beyond a last-occurrence
+ * table, which also lets it skip ahead on bytes absent from the needle.
+ */
+int vm_string_twoway(unsigned char const *h, int hl, unsigned char const *n, int l) {
+    int i, ip, jp, k, p, p0, ms, mem, mem0, pos;
+    int shift[256];
+    memset(shift,0,sizeof(shift));
+    for (i=0; i<l; i++) { shift[n[i]] = i+1; }
+
+    /* Critical factorization: the larger of the two maximal suffixes */
+    ip = -1; jp = 0; k = p = 1;
+    while (jp+k < l) {
+        if (n[ip+k] == n[jp+k]) {
+            if (k == p) { jp += p; k = 1; } else { k++; }
+        } else if (n[ip+k] > n[jp+k]) {
+            jp += k; k = 1; p = jp-ip;
+        } else {
+            ip = jp++; k = p = 1;
+        }
+    }
+    ms = ip; p0 = p;
+    ip = -1; jp = 0; k = p = 1;
+    while (jp+k < l) {
+        if (n[ip+k] == n[jp+k]) {
+            if (k == p) { jp += p; k = 1; } else { k++; }
+        } else if (n[ip+k] < n[jp+k]) {
+            jp += k; k = 1; p = jp-ip;
+        } else {
+            ip = jp++; k = p = 1;
         }
+    }
+    if (ip+1 > ms+1) { ms = ip; } else { p = p0; }
+
+    if (memcmp(n,n+p,ms+1)) {
+        mem0 = 0;
+        p = vm_max(ms,l-ms-1)+1;
+    } else {
+        mem0 = l-p;
+    }
+    mem = 0;
+
+    pos = 0;
+    while (hl-pos >= l) {
+        unsigned char const *hp = h+pos;
+        k = shift[hp[l-1]];
+        if (!k) { pos += l; mem = 0; continue; }
+        k = l-k;
+        if (k) {
+            pos += vm_max(k,mem); mem = 0;
+            continue;
+        }
+        for (k=vm_max(ms+1,mem); k<l && n[k] == hp[k]; k++);
+        if (k < l) { pos += k-ms; mem = 0; continue; }
+        for (k=ms+1; k>mem && n[k-1] == hp[k-1]; k--);
+        if (k <= mem) { return pos; }
+        pos += p; mem = mem0;
+    }
+    return -1;
+}
+
+/* Function: vm_string_filter
+ * Search for short needles by their first and last byte.
+ *
+ * Candidate positions must match both the first and the last byte of the
+ * needle, which SSE2 tests for 16 positions at a time; only those are
+ * compared in full.
+ */
+int vm_string_filter(char const *s, int n, char const *k, int m) {
+    int i = 0;
+#ifdef __SSE2__
+    __m128i first = _mm_set1_epi8(k[0]);
+    __m128i last = _mm_set1_epi8(k[m-1]);
+    for (; i+m-1+16 <= n; i += 16) {
+        __m128i a = _mm_cmpeq_epi8(first,_mm_loadu_si128((__m128i const*)(s+i)));
+        __m128i b = _mm_cmpeq_epi8(last,_mm_loadu_si128((__m128i const*)(s+i+m-1)));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(a,b));
+        while (mask) {
+            int j = i+__builtin_ctz(mask);
+            if (memcmp(s+j+1,k+1,m-2) == 0) { return j; }
+            mask &= mask-1;
+        }
+    }
+#endif
+    while (i <= n-m) {
+        char const *p = (char const *)memchr(s+i,k[0],n-m+1-i);
+        if (!p) { return -1; }
+        i = p-s;
+        if (s[i+m-1] == k[m-1] && memcmp(s+i+1,k+1,m-2) == 0) { return i; }
         i += 1;
     }
     return -1;
 }
 
+/* Function: vm_string_search
+ * Offset of the first occurrence of k[0..m) in s[0..n), or -1.
+ *
+ * Single bytes go to memchr, short needles to <vm_string_filter> and long
+ * ones to <vm_string_twoway>.
+ */
+int vm_string_search(char const *s, int n, char const *k, int m) {
+    char const *p;
+    if (m == 0) { return 0; }
+    if (m > n) { return -1; }
+    if (m == 1) {
+        p = (char const *)memchr(s,k[0],n);
+        return p ? p-s : -1;
+    }
+    if (m < vm_def_TWOWAY_MIN) { return vm_string_filter(s,n,k,m); }
+    return vm_string_twoway((unsigned char const *)s,n,(unsigned char const *)k,m);
+}
+
+int vm_string_index(type_vmObj s, type_vmObj k) {
+    return vm_string_search(s.string.val,s.string.len,k.string.val,k.string.len);
+}
+
+/* Function: vm_string_uleads_sub
+ * Number of code points in s[0..n).
+ *
+ * Code points are counted by their lead bytes, ie all bytes except the
+ * 10xxxxxx continuation bytes, which is also well defined for invalid
+ * UTF-8 and for views that cut a character in two.
+ */
+int vm_string_uleads_sub(char const *s, int n) {
+    int i = 0, r = 0;
+#ifdef __SSE2__
+    __m128i c0 = _mm_set1_epi8((char)0xc0), c8 = _mm_set1_epi8((char)0x80);
+    for (; i+16 <= n; i += 16) {
+        __m128i x = _mm_and_si128(_mm_loadu_si128((__m128i const*)(s+i)),c0);
+        r += 16-__builtin_popcount((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(x,c8)));
+    }
+#endif
+    for (; i<n; i++) { r += (s[i]&0xc0) != 0x80; }
+    return r;
+}
+
+/* Offset of code point k in s[0..n), or n when there are not that many. */
+int vm_string_ufind_sub(char const *s, int n, int k) {
+    int i = 0;
+    for (; i+16 <= n; i += 16) {
+        int c = vm_string_uleads_sub(s+i,16);
+        if (c > k) { break; }
+        k -= c;
+    }
+    for (; i<n; i++) {
+        if ((s[i]&0xc0) != 0x80 && k-- == 0) { return i; }
+    }
+    return n;
+}
+
+/* Extends the block index of self to cover all of its bytes. In place
+ * concatenation only adds bytes, so existing entries stay valid. */
+static void vm_string_uindex(type_vmString *self) {
+    int n = self->len/vm_def_UBLOCK+1, j;
+    if (self->ublocks >= n) { return; }
+    self->uindex = (int*)realloc(self->uindex,n*sizeof(int));/*realloc(x,y)*/
+    j = self->ublocks;
+    if (!j) { self->uindex[j++] = 0; }
+    for (; j<n; j++) {
+        self->uindex[j] = self->uindex[j-1]+vm_string_uleads_sub(self->s+(j-1)*vm_def_UBLOCK,vm_def_UBLOCK);
+    }
+    self->ublocks = n;
+}
+
+/* Function: vm_string_uleads
+ * Number of code points in self->s[0..p).
+ *
+ * Uses the block index, so only the bytes of one block are counted.
+ */
+int vm_string_uleads(type_vmString *self, int p) {
+    int j = p/vm_def_UBLOCK;
+    if (j >= self->ublocks) { vm_string_uindex(self); }
+    return self->uindex[j]+vm_string_uleads_sub(self->s+j*vm_def_UBLOCK,p-j*vm_def_UBLOCK);
+}
+
+/* Offset of code point k of self->s, or self->len. */
+int vm_string_ufind(type_vmString *self, int k) {
+    int a = 0, b, m;
+    vm_string_uindex(self);
+    b = self->ublocks-1;
+    while (a < b) {
+        m = (a+b+1)/2;
+        if (self->uindex[m] <= k) { a = m; } else { b = m-1; }
+    }
+    m = a*vm_def_UBLOCK;
+    return m+vm_string_ufind_sub(self->s+m,self->len-m,k-self->uindex[a]);
+}
+
+/* True if the code point index of o's storage is worth having. */
+vm_inline static int vm_string_indexed(type_vmObj o) {
+    return o.string.info && o.string.info->len >= vm_def_UINDEX_MIN;
+}
+
+/* Function: vm_string_ulen
+ * Number of code points in o.
+ */
+int vm_string_ulen(type_vmObj o) {
+    if (vm_string_indexed(o)) {
+        int a = o.string.val-o.string.info->s;
+        return vm_string_uleads(o.string.info,a+o.string.len)-vm_string_uleads(o.string.info,a);
+    }
+    return vm_string_uleads_sub(o.string.val,o.string.len);
+}
+
+/* Function: vm_string_uoffset
+ * Byte offset of code point k of o, or the length of o in bytes.
+ */
+int vm_string_uoffset(type_vmObj o, int k) {
+    if (vm_string_indexed(o)) {
+        int a = o.string.val-o.string.info->s;
+        int r = vm_string_ufind(o.string.info,vm_string_uleads(o.string.info,a)+k)-a;
+        return vm_min(r,o.string.len);
+    }
+    return vm_string_ufind_sub(o.string.val,o.string.len,k);
+}
+
+/* Function: vm_string_isutf8_sub
+ * True if s[0..n) is well formed UTF-8.
+ *
+ * Runs of ASCII are skipped 16 bytes at a time with SSE2. Overlong forms,
+ * surrogates and code points above U+10FFFF are rejected.
+ */
+int vm_string_isutf8_sub(unsigned char const *s, int n) {
+    int i = 0;
+    while (i < n) {
+        int c = s[i], k, min;
+        unsigned long v;
+#ifdef __SSE2__
+        if (c < 0x80 && i+16 <= n && !_mm_movemask_epi8(_mm_loadu_si128((__m128i const*)(s+i)))) {
+            i += 16;
+            continue;
+        }
+#endif
+        if (c < 0x80) { i++; continue; }
+        else if ((c&0xe0) == 0xc0) { k = 1; v = c&0x1f; min = 0x80; }
+        else if ((c&0xf0) == 0xe0) { k = 2; v = c&0x0f; min = 0x800; }
+        else if ((c&0xf8) == 0xf0) { k = 3; v = c&0x07; min = 0x10000; }
+        else { return 0; }
+        if (i+k >= n) { return 0; }
+        for (i++; k; k--, i++) {
+            if ((s[i]&0xc0) != 0x80) { return 0; }
+            v = (v<<6)|(s[i]&0x3f);
+        }
+        if (v < (unsigned long)min || v > 0x10ffff || (v >= 0xd800 && v <= 0xdfff)) { return 0; }
+    }
+    return 1;
+}
+
+/* The code point of o starting at byte a, as a view. */
+static type_vmObj vm_string_uchar(type_vm *tp, type_vmObj o, int a) {
+    int b = a+1;
+    while (b < o.string.len && (o.string.val[b]&0xc0) == 0x80) { b++; }
+    if (b-a == 1) { return vm_string_n(tp->chars[(unsigned char)o.string.val[a]],1); }
+    return vm_string_substring(tp,o,a,b);
+}
+
+type_vmObj vm_string_ulen2(type_vm *tp) {
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    return vm_create_numericObj(vm_string_ulen(o));
+}
+
+/* s.uat(i) is the i-th code point of s, negative i counting from the end. */
+type_vmObj vm_string_uat(type_vm *tp) {
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    int i = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;
+    int a;
+    if (i < 0) { i += vm_string_ulen(o); }
+    a = i < 0 ? o.string.len : vm_string_uoffset(o,i);
+    if (a >= o.string.len) {
+        vm_raise(tp,vm_string("(vm_string_uat) IndexError: string index out of range"));
+    }
+    return vm_string_uchar(tp,o,a);
+}
+
+/* s.uslice(a,b) slices s by code points, like s[a:b] does by bytes. */
+type_vmObj vm_string_uslice(type_vm *tp) {
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    int a = vm_typecheck(tp,vm_enum1_number,vm_operations_get(tp,tp->params,vm_none)).number.val;
+    type_vmObj e = vm_macros_DEFAULT(vm_none);
+    int l = -1, b;
+    if (a < 0 || e.type != vm_enum1_number || e.number.val < 0) { l = vm_string_ulen(o); }
+    b = e.type == vm_enum1_number ? (int)e.number.val : l;
+    a = vm_max(0,(a<0?l+a:a)); b = vm_max(a,(b<0?l+b:b));
+    return vm_string_substring(tp,o,vm_string_uoffset(o,a),vm_string_uoffset(o,b));
+}
+
+/* s.uchars() is the list of the code points of s. */
+type_vmObj vm_string_uchars(type_vm *tp) {
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj r = vm_list(tp);
+    int a = 0;
+    vm_list_realloc(tp,r.list.val,vm_string_uleads_sub(o.string.val,o.string.len));
+    while (a < o.string.len) {
+        type_vmObj c = vm_string_uchar(tp,o,a);
+        vm_list_appendx(tp,r.list.val,c);
+        a += c.string.len;
+    }
+    vm_gc_grey(tp,o);
+    return r;
+}
+
+type_vmObj vm_string_isutf8(type_vm *tp) {
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    return vm_create_numericObj(vm_string_isutf8_sub((unsigned char const *)o.string.val,o.string.len));
+}
+
+/* Function: vm_builder_reserve
+ * Makes room for n more bytes in self.
+ *
+ * The storage at least doubles each time it grows, so appending to a
+ * builder is linear overall.
+ */
+void vm_builder_reserve(type_vmBuilder *self, int n) {
+    int alloc;
+    if (self->len + n <= self->alloc) { return; }
+    alloc = vm_max(vm_max(64,self->alloc*2),self->len+n);
+    self->info = (type_vmString*)realloc(self->info,sizeof(type_vmString)+alloc);/*realloc(x,y)*/
+    self->alloc = alloc;
+}
+
+void vm_builder_write(type_vmBuilder *self, char const *s, int n) {
+    vm_builder_reserve(self,n);
+    memcpy(self->info->s+self->len,s,n);
+    self->len += n;
+}
+
+/* Appends str(v), which only converts v once. */
+void vm_builder_append(type_vm *tp, type_vmBuilder *self, type_vmObj v) {
+    v = vm_operations_str(tp,v);
+    vm_builder_write(self,v.string.val,v.string.len);
+}
+
+/* Function: vm_builder_finish
+ * Turns the contents of self into a string and empties self.
+ *
+ * The storage is handed over to the string instead of being copied.
+ */
+type_vmObj vm_builder_finish(type_vm *tp, type_vmBuilder *self) {
+    type_vmObj r = vm_string_n(0,self->len);
+    if (!self->len) {
+        free(self->info);
+        self->info = 0; self->alloc = 0;
+        return vm_string("");
+    }
+    r.string.info = (type_vmString*)realloc(self->info,sizeof(type_vmString)+self->len);/*realloc(x,y)*/
+    r.string.info->gci = 0;
+    r.string.info->len = self->len;
+    r.string.info->alloc = self->len;
+    r.string.info->uindex = 0;
+    r.string.info->ublocks = 0;
+    r.string.info->s[self->len] = 0;
+    r.string.val = r.string.info->s;
+    self->info = 0; self->len = 0; self->alloc = 0;
+    return vm_gc_track(tp,r);
+}
+
+/* Appends the items to b with delim between them. An item's __str__ may
+ * raise partway, so the storage of b is freed before passing that on. */
+static void vm_string_join_sub(type_vm *tp, type_vmBuilder *b, type_vmObj delim, type_vmList *items) {
+    jmp_buf outer;
+    int i;
+    memcpy(outer,tp->buf,sizeof(jmp_buf));
+    if (setjmp(tp->buf)) {
+        memcpy(tp->buf,outer,sizeof(jmp_buf));
+        free(b->info);
+        vm_raise(tp,vm_none);
+    }
+    for (i=0; i<items->len; i++) {
+        if (i!=0) { vm_builder_write(b,delim.string.val,delim.string.len); }
+        vm_builder_append(tp,b,vm_list_at(items,i));
+    }
+    memcpy(tp->buf,outer,sizeof(jmp_buf));
+}
+
 type_vmObj vm_string_join(type_vm *tp) {
     type_vmObj delim = vm_operations_get(tp,tp->params,vm_none);
     type_vmObj val = vm_operations_get(tp,tp->params,vm_none);
+    type_vmList *items = val.list.val;
+    type_vmBuilder b = {0,0,0};
     int l=0,i;
-    type_vmObj r;
-    char *s;
-    for (i=0; i<val.list.val->len; i++) {
-        if (i!=0) { l += delim.string.len; }
-        l += vm_operations_str(tp,val.list.val->items[i]).string.len;
+    /* strings are measured up front so joining them allocates once */
+    for (i=0; i<items->len && !items->nums; i++) {
+        if (items->items[i].type == vm_enum1_string) { l += items->items[i].string.len; }
     }
-    r = vm_string_new(tp,l);
-    s = r.string.info->s;
-    l = 0;
-    for (i=0; i<val.list.val->len; i++) {
-        type_vmObj e;
-        if (i!=0) {
-            memcpy(s+l,delim.string.val,delim.string.len); l += delim.string.len;
+    vm_builder_reserve(&b,l+vm_max(0,items->len-1)*delim.string.len);
+    vm_string_join_sub(tp,&b,delim,items);
+    return vm_builder_finish(tp,&b);
+}
+
+/* Function: vm_string_matches
+ * Offsets of the non-overlapping occurrences of k in s.
+ *
+ * Scans s once and stops after limit matches (limit < 0 means no limit).
+ * An empty k matches at every offset, end included. Returns the number of
+ * matches; *r is set to a malloc'd array of their offsets which the caller
+ * frees, or to 0 when there are none.
+ */
+int vm_string_matches(type_vmObj s, type_vmObj k, int limit, int **r) {
+    int n = 0, alloc = 0, i = 0, j;
+    *r = 0;
+    while (n != limit && i <= s.string.len) {
+        j = vm_string_search(s.string.val+i,s.string.len-i,k.string.val,k.string.len);
+        if (j < 0) { break; }
+        if (n == alloc) {
+            alloc = vm_max(16,alloc*2);
+            *r = (int*)realloc(*r,alloc*sizeof(int));/*realloc(x,y)*/
         }
-        e = vm_operations_str(tp,val.list.val->items[i]);
-        memcpy(s+l,e.string.val,e.string.len); l += e.string.len;
+        (*r)[n++] = i+j;
+        i += j+vm_max(1,k.string.len);
     }
-    return vm_gc_track(tp,r);
+    return n;
 }
 
 type_vmObj vm_string_split(type_vm *tp) {
     type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
     type_vmObj d = vm_operations_get(tp,tp->params,vm_none);
+    int limit = vm_macros_DEFAULT(vm_create_numericObj(-1)).number.val;
     type_vmObj r = vm_list(tp);
-
-    int i;
-    while ((i=vm_string_index(v,d))!=-1) {
-        vm_list_append(tp,r.list.val,vm_string_substring(tp,v,0,i));
-        v.string.val += i + d.string.len; v.string.len -= i + d.string.len;
+    int *m;
+    int i,a = 0,n;
+    if (!d.string.len) {
+        vm_raise(tp,vm_string("(vm_string_split) ValueError: empty separator"));
     }
-    vm_list_append(tp,r.list.val,vm_string_substring(tp,v,0,v.string.len));
+    n = vm_string_matches(v,d,limit,&m);
+    vm_list_realloc(tp,r.list.val,n+1);
+    for (i=0; i<n; i++) {
+        vm_list_appendx(tp,r.list.val,vm_string_substring(tp,v,a,m[i]));
+        a = m[i]+d.string.len;
+    }
+    vm_list_appendx(tp,r.list.val,vm_string_substring(tp,v,a,v.string.len));
+    free(m);
+    /* every piece is a view of v */
+    vm_gc_grey(tp,v);
     return r;
 }
 
@@ -137,55 +711,286 @@ type_vmObj vm_string_ord(type_vm *tp) {
     return vm_create_numericObj((unsigned char)s.string.val[0]);
 }
 
+/* Byte classes for <vm_string_span>. Whitespace is what strip() removes. */
+#define vm_def_CLASS_SPACE 0
+#define vm_def_CLASS_DIGIT 1
+#define vm_def_CLASS_ALPHA 2
+#define vm_def_CLASS_UPPER 3
+#define vm_def_CLASS_LOWER 4
+
+static int vm_string_inclass(unsigned char c, int cls) {
+    switch (cls) {
+        case vm_def_CLASS_SPACE: return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+        case vm_def_CLASS_DIGIT: return (unsigned char)(c-'0') <= 9;
+        case vm_def_CLASS_ALPHA: return (unsigned char)((c|0x20)-'a') <= 25;
+        case vm_def_CLASS_UPPER: return (unsigned char)(c-'A') <= 25;
+        case vm_def_CLASS_LOWER: return (unsigned char)(c-'a') <= 25;
+    }
+    return 0;
+}
+
+#ifdef __SSE2__
+/* 0xff in each byte of x that lies in lo..hi. */
+vm_inline static __m128i vm_string_range(__m128i x, char lo, char hi) {
+    __m128i k = _mm_set1_epi8((char)(hi-lo));
+    x = _mm_sub_epi8(x,_mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_max_epu8(x,k),k);
+}
+
+/* Bit i is set when byte i of s[0..16) is in class cls. */
+vm_inline static unsigned int vm_string_classmask(char const *s, int cls) {
+    __m128i x = _mm_loadu_si128((__m128i const*)s), m;
+    switch (cls) {
+        case vm_def_CLASS_SPACE:
+            m = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(x,_mm_set1_epi8(' ')),_mm_cmpeq_epi8(x,_mm_set1_epi8('\n'))),
+                _mm_or_si128(_mm_cmpeq_epi8(x,_mm_set1_epi8('\t')),_mm_cmpeq_epi8(x,_mm_set1_epi8('\r'))));
+            break;
+        case vm_def_CLASS_DIGIT: m = vm_string_range(x,'0','9'); break;
+        case vm_def_CLASS_ALPHA: m = vm_string_range(_mm_or_si128(x,_mm_set1_epi8(0x20)),'a','z'); break;
+        case vm_def_CLASS_UPPER: m = vm_string_range(x,'A','Z'); break;
+        default: m = vm_string_range(x,'a','z'); break;
+    }
+    return (unsigned int)_mm_movemask_epi8(m);
+}
+#endif
+
+/* Function: vm_string_span
+ * Length of the longest prefix of s[0..n) whose bytes are all in class
+ * cls (in = 1) or all outside of it (in = 0).
+ */
+int vm_string_span(char const *s, int n, int cls, int in) {
+    int i = 0;
+#ifdef __SSE2__
+    for (; i+16 <= n; i += 16) {
+        unsigned int stop = (in ? ~vm_string_classmask(s+i,cls) : vm_string_classmask(s+i,cls)) & 0xffff;
+        if (stop) { return i+__builtin_ctz(stop); }
+    }
+#endif
+    while (i < n && vm_string_inclass(s[i],cls) == in) { i++; }
+    return i;
+}
+
+/* Function: vm_string_rspan
+ * <vm_string_span> for the longest suffix.
+ */
+int vm_string_rspan(char const *s, int n, int cls, int in) {
+    int i = n;
+#ifdef __SSE2__
+    for (; i >= 16; i -= 16) {
+        unsigned int stop = (in ? ~vm_string_classmask(s+i-16,cls) : vm_string_classmask(s+i-16,cls)) & 0xffff;
+        if (stop) { return n-i+(__builtin_clz(stop)-16); }
+    }
+#endif
+    while (i > 0 && vm_string_inclass(s[i-1],cls) == in) { i--; }
+    return n-i;
+}
+
+/* Returns a view, so stripping never copies. */
 type_vmObj vm_string_strip(type_vm *tp) {
     type_vmObj o = vm_typecheck(tp,vm_enum1_string,vm_operations_get(tp,tp->params,vm_none));
-    char const *v = o.string.val; int l = o.string.len;
-    int i; int a = l, b = 0;
+    int a = vm_string_span(o.string.val,o.string.len,vm_def_CLASS_SPACE,1);
+    if (a == o.string.len) { return vm_string(""); }
+    return vm_string_substring(tp,o,a,o.string.len-vm_string_rspan(o.string.val,o.string.len,vm_def_CLASS_SPACE,1));
+}
+
+static type_vmObj vm_string_is(type_vm *tp, int cls) {
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    int n = o.string.len;
+    return vm_create_numericObj(n && vm_string_span(o.string.val,n,cls,1) == n);
+}
+type_vmObj vm_string_isspace(type_vm *tp) { return vm_string_is(tp,vm_def_CLASS_SPACE); }
+type_vmObj vm_string_isdigit(type_vm *tp) { return vm_string_is(tp,vm_def_CLASS_DIGIT); }
+type_vmObj vm_string_isalpha(type_vm *tp) { return vm_string_is(tp,vm_def_CLASS_ALPHA); }
+
+/* Flips the case of the bytes in class cls, returning o itself when there
+ * are none. */
+static type_vmObj vm_string_case(type_vm *tp, type_vmObj o, int cls) {
+    char const *s = o.string.val;
+    int n = o.string.len;
+    int i = vm_string_span(s,n,cls,0);
     type_vmObj r;
-    char *s;
-    for (i=0; i<l; i++) {
-        if (v[i] != ' ' && v[i] != '\n' && v[i] != '\t' && v[i] != '\r') {
-            a = vm_min(a,i); b = vm_max(b,i+1);
-        }
+    char *d;
+    if (i == n) { return o; }
+    r = vm_string_new(tp,n);
+    d = r.string.info->s;
+    memcpy(d,s,i);
+#ifdef __SSE2__
+    for (; i+16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(s+i));
+        __m128i m = cls == vm_def_CLASS_UPPER ? vm_string_range(x,'A','Z') : vm_string_range(x,'a','z');
+        _mm_storeu_si128((__m128i*)(d+i),_mm_xor_si128(x,_mm_and_si128(m,_mm_set1_epi8(0x20))));
     }
-    if ((b-a) < 0) { return vm_string(""); }
-    r = vm_string_new(tp,b-a);
-    s = r.string.info->s;
-    memcpy(s,v+a,b-a);
+#endif
+    for (; i<n; i++) {
+        d[i] = vm_string_inclass(s[i],cls) ? (char)(s[i]^0x20) : s[i];
+    }
+    return vm_gc_track(tp,r);
+}
+type_vmObj vm_string_lower(type_vm *tp) {
+    return vm_string_case(tp,vm_operations_get(tp,tp->params,vm_none),vm_def_CLASS_UPPER);
+}
+type_vmObj vm_string_upper(type_vm *tp) {
+    return vm_string_case(tp,vm_operations_get(tp,tp->params,vm_none),vm_def_CLASS_LOWER);
+}
+
+/* Function: vm_string_translate
+ * s.translate(frm,to) replaces every byte frm[i] by to[i].
+ */
+type_vmObj vm_string_translate(type_vm *tp) {
+    type_vmObj o = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj frm = vm_typecheck(tp,vm_enum1_string,vm_operations_get(tp,tp->params,vm_none));
+    type_vmObj to = vm_typecheck(tp,vm_enum1_string,vm_operations_get(tp,tp->params,vm_none));
+    unsigned char const *s = (unsigned char const *)o.string.val;
+    unsigned char table[256];
+    type_vmObj r;
+    char *d;
+    int i;
+    if (frm.string.len != to.string.len) {
+        vm_raise(tp,vm_string("(vm_string_translate) ValueError: arguments must have equal length"));
+    }
+    for (i=0; i<256; i++) { table[i] = (unsigned char)i; }
+    for (i=0; i<frm.string.len; i++) { table[(unsigned char)frm.string.val[i]] = to.string.val[i]; }
+    r = vm_string_new(tp,o.string.len);
+    d = r.string.info->s;
+    for (i=0; i<o.string.len; i++) { d[i] = (char)table[s[i]]; }
     return vm_gc_track(tp,r);
 }
 
+/* Function: vm_string_count
+ * Number of non-overlapping occurrences of k in s[0..n).
+ */
+int vm_string_count_sub(char const *s, int n, char const *k, int m) {
+    int i = 0, r = 0, j;
+    if (m == 0) { return n+1; }
+    if (m == 1) {
+#ifdef __SSE2__
+        __m128i c = _mm_set1_epi8(k[0]);
+        for (; i+16 <= n; i += 16) {
+            __m128i x = _mm_loadu_si128((__m128i const*)(s+i));
+            r += __builtin_popcount((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(x,c)));
+        }
+#endif
+        for (; i<n; i++) { r += s[i] == k[0]; }
+        return r;
+    }
+    while ((j = vm_string_search(s+i,n-i,k,m)) >= 0) {
+        r += 1;
+        i += j+m;
+    }
+    return r;
+}
+
+type_vmObj vm_string_count(type_vm *tp) {
+    type_vmObj s = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj k = vm_typecheck(tp,vm_enum1_string,vm_operations_get(tp,tp->params,vm_none));
+    return vm_create_numericObj(vm_string_count_sub(s.string.val,s.string.len,k.string.val,k.string.len));
+}
+
 type_vmObj vm_string_replace(type_vm *tp) {
     type_vmObj s = vm_operations_get(tp,tp->params,vm_none);
     type_vmObj k = vm_operations_get(tp,tp->params,vm_none);
     type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
-    type_vmObj p = s;
-    int i,n = 0;
-    int c;
-    int l;
+    int limit = vm_macros_DEFAULT(vm_create_numericObj(-1)).number.val;
     type_vmObj rr;
-    char *r;
     char *d;
-    type_vmObj z;
-    while ((i = vm_string_index(p,k)) != -1) {
-        n += 1;
-        p.string.val += i + k.string.len; p.string.len -= i + k.string.len;
-    }
-/*     fprintf(stderr,"ns: %d\n",n); */
-    l = s.string.len + n * (v.string.len-k.string.len);
-    rr = vm_string_new(tp,l);
-    r = rr.string.info->s;
-    d = r;
-    z = p = s;
-    while ((i = vm_string_index(p,k)) != -1) {
-        p.string.val += i; p.string.len -= i;
-        memcpy(d,z.string.val,c=(p.string.val-z.string.val)); d += c;
-        p.string.val += k.string.len; p.string.len -= k.string.len;
+    int *m;
+    int i,a = 0;
+    int n = vm_string_matches(s,k,limit,&m);
+    if (!n) { return s; }
+    rr = vm_string_new(tp,s.string.len + n * (v.string.len-k.string.len));
+    d = rr.string.info->s;
+    for (i=0; i<n; i++) {
+        memcpy(d,s.string.val+a,m[i]-a); d += m[i]-a;
         memcpy(d,v.string.val,v.string.len); d += v.string.len;
-        z = p;
+        a = m[i]+k.string.len;
     }
-    memcpy(d,z.string.val,(s.string.val + s.string.len) - z.string.val);
-
+    memcpy(d,s.string.val+a,s.string.len-a);
+    free(m);
     return vm_gc_track(tp,rr);
 }
 
+/* Function: builder
+ * Mutable string buffer for building text piece by piece.
+ *
+ * Example:
+ * > b = builder()
+ * > b.append("x = "); b.append(12)
+ * > b.extend([";", " y"])
+ * > s = b.build()
+ */
+vm_inline static type_vmBuilder *vm_builder_self(type_vm *tp) {
+    return (type_vmBuilder*)vm_operations_get(tp,tp->params,vm_none).data.val;
+}
+
+type_vmObj vm_builder_append2(type_vm *tp) {
+    type_vmBuilder *self = vm_builder_self(tp);
+    vm_builder_append(tp,self,vm_operations_get(tp,tp->params,vm_none));
+    return vm_none;
+}
+
+type_vmObj vm_builder_extend(type_vm *tp) {
+    type_vmBuilder *self = vm_builder_self(tp);
+    type_vmObj v = vm_typecheck(tp,vm_enum1_list,vm_operations_get(tp,tp->params,vm_none));
+    int i;
+    for (i=0; i<v.list.val->len; i++) {
+        vm_builder_append(tp,self,vm_list_at(v.list.val,i));
+    }
+    return vm_none;
+}
+
+type_vmObj vm_builder_build(type_vm *tp) {
+    type_vmBuilder *self = vm_builder_self(tp);
+    if (!self->len) { return vm_string(""); }
+    return vm_string_copy(tp,self->info->s,self->len);
+}
+
+type_vmObj vm_builder_clear(type_vm *tp) {
+    vm_builder_self(tp)->len = 0;
+    return vm_none;
+}
+
+type_vmObj vm_builder_get(type_vm *tp, type_vmObj self, type_vmObj k) {
+    if (k.type == vm_enum1_string) {
+        if (vm_operations_cmp(tp,vm_string("append"),k) == 0) {
+            return vm_misc_method(tp,self,vm_builder_append2);
+        } else if (vm_operations_cmp(tp,vm_string("extend"),k) == 0) {
+            return vm_misc_method(tp,self,vm_builder_extend);
+        } else if (vm_operations_cmp(tp,vm_string("build"),k) == 0) {
+            return vm_misc_method(tp,self,vm_builder_build);
+        } else if (vm_operations_cmp(tp,vm_string("clear"),k) == 0) {
+            return vm_misc_method(tp,self,vm_builder_clear);
+        }
+    }
+    vm_raise(0,vm_string("(vm_builder_get) KeyError"));
+    return vm_none;
+}
+
+type_vmObj vm_builder_len(type_vm *tp, type_vmObj self) {
+    return vm_create_numericObj(((type_vmBuilder*)self.data.val)->len);
+}
+
+type_vmObj vm_builder_str(type_vm *tp, type_vmObj self) {
+    type_vmBuilder *b = (type_vmBuilder*)self.data.val;
+    if (!b->len) { return vm_string(""); }
+    return vm_string_copy(tp,b->info->s,b->len);
+}
+
+void vm_builder_free(type_vm *tp, type_vmObj self) {
+    type_vmBuilder *b = (type_vmBuilder*)self.data.val;
+    free(b->info);
+    free(b);
+}
+
+/* Function: vm_string_builder
+ * Creates an empty string builder.
+ */
+type_vmObj vm_string_builder(type_vm *tp) {
+    type_vmBuilder *b = (type_vmBuilder*)calloc(sizeof(type_vmBuilder),1);/*calloc((x),1)*/
+    type_vmObj r = vm_misc_dataObj(tp,vm_enum3_builder,b);
+    r.data.info->free = vm_builder_free;
+    r.data.info->get = vm_builder_get;
+    r.data.info->len = vm_builder_len;
+    r.data.info->str = vm_builder_str;
+    return r;
+}
@@ -5,7 +5,11 @@
 #include "dict.c"
 #include "misc.c"
 #include "string.c"
+#include "bytes.c"
+#include "deque.c"
+#include "set.c"
 #include "vm_api.c"
+#include "shape.c"
 #include "gc.c"
 #include "operations.c"
 
@@ -28,18 +32,30 @@ type_vm *sub_vm_init(void) {
     vm->curFrame = 0;
     vm->jmp = 0;
     vm->ex = vm_none;
+    vm->hash_seed = vm_dict_seed(vm);
     vm->root = vm_list_nt(vm);
     for (i=0; i<256; i++) { vm->chars[i][0]=i; }
+    vm_string_init(vm);
     vm_gc_init(vm);
+    vm_shape_init(vm);
     vm->regs_sub = vm_list(vm);
+    vm->regs_sub.list.val->pinned = 1;
     for (i=0; i<vm_def_REGS; i++) { vm_operations_set(vm,vm->regs_sub,vm_none,vm_none); }
+    vm->strs_sub = vm_list(vm);
+    vm->strs_sub.list.val->pinned = 1;
+    for (i=0; i<vm_def_STRS; i++) { vm_operations_set(vm,vm->strs_sub,vm_none,vm_none); }
     vm->builtins = vm_dict_create(vm);
     vm->modules = vm_dict_create(vm);
     vm->params_sub = vm_list(vm);
-    for (i=0; i<vm_def_FRAMES; i++) { vm_operations_set(vm,vm->params_sub,vm_none,vm_list(vm)); }
+    for (i=0; i<vm_def_FRAMES; i++) {
+        type_vmObj params = vm_list(vm);
+        params.list.val->pinned = 1;
+        vm_operations_set(vm,vm->params_sub,vm_none,params);
+    }
     vm_operations_set(vm,vm->root,vm_none,vm->builtins);
     vm_operations_set(vm,vm->root,vm_none,vm->modules);
     vm_operations_set(vm,vm->root,vm_none,vm->regs_sub);
+    vm_operations_set(vm,vm->root,vm_none,vm->strs_sub);
     vm_operations_set(vm,vm->root,vm_none,vm->params_sub);
     vm_operations_set(vm,vm->builtins,vm_string("MODULES"),vm->modules);
     vm_operations_set(vm,vm->modules,vm_string("BUILTINS"),vm->builtins);
@@ -52,6 +68,7 @@ type_vm *sub_vm_init(void) {
     /*end defines from src/defines*/
     vm_operations_set(vm,vm->modules, vm_string("sys"), sys);
     vm->regs = vm->regs_sub.list.val->items;
+    vm->strs = vm->strs_sub.list.val->items;
     vm_gc_full(vm);
     return vm;
 }
@@ -71,6 +88,7 @@ void vm_deinit(type_vm *tp) {
     vm_gc_full(tp); vm_gc_full(tp);
     vm_gc_delete(tp,tp->root);
     vm_gc_deinit(tp);
+    vm_shape_deinit(tp);
     tp->mem_used -= sizeof(type_vm);
     free(tp);
 }
@@ -188,7 +206,7 @@ type_vmObj vm_call_sub(type_vm *tp,type_vmObj self, type_vmObj params) {
         vm_frame(tp,self.fnc.info->globals,self.fnc.info->code,&dest);
         if ((self.fnc.ftype&2)) {
             tp->frames[tp->curFrame].regs[0] = params;
-            vm_list_insert(tp,params.list.val,0,self.fnc.info->self);
+            vm_list_insert(tp,params.list.val,0,vm_misc_fnc_self(self));
         } else {
             tp->frames[tp->curFrame].regs[0] = params;
         }
@@ -247,9 +265,18 @@ int vm_step(type_vm *tp) {
         case vm_enum2_PASS: break;
         case vm_enum2_IF: if (vm_operations_bool(tp,regs[e.regs.a])) { curFrame += 1; } break;
         case vm_enum2_IFN: if (!vm_operations_bool(tp,regs[e.regs.a])) { curFrame += 1; } break;
-        case vm_enum2_GET: regs[e.regs.a] = vm_operations_get(tp,regs[e.regs.b],regs[e.regs.c]); vm_macro_GA; break;
+        case vm_enum2_GET: regs[e.regs.a] = vm_shape_get(tp,curFrame,regs[e.regs.b],regs[e.regs.c]); vm_macro_GA; break;
         case vm_enum2_ITER:
-            if (regs[e.regs.c].number.val < vm_operations_len(tp,regs[e.regs.b]).number.val) {
+            if (regs[e.regs.b].type == vm_enum1_dict) {
+                /* the counter is an entry number, see vm_dict_iter */
+                type_vmDict *d = regs[e.regs.b].dict.val;
+                int n = vm_dict_iter(d,regs[e.regs.c].number.val);
+                if (n >= 0) {
+                    regs[e.regs.a] = d->items[n].key; vm_macro_GA;
+                    regs[e.regs.c].number.val = n+1;
+                    curFrame += 1;
+                }
+            } else if (regs[e.regs.c].number.val < vm_operations_len(tp,regs[e.regs.b]).number.val) {
                 regs[e.regs.a] = vm_operations_iterate(tp,regs[e.regs.b],regs[e.regs.c]); vm_macro_GA;
                 regs[e.regs.c].number.val += 1;
                 curFrame += 1;
@@ -257,7 +284,7 @@ int vm_step(type_vm *tp) {
             break;
         case vm_enum2_HAS: regs[e.regs.a] = vm_operations_haskey(tp,regs[e.regs.b],regs[e.regs.c]); break;
         case vm_enum2_IGET: vm_operations_safeget(tp,&regs[e.regs.a],regs[e.regs.b],regs[e.regs.c]); break;
-        case vm_enum2_SET: vm_operations_set(tp,regs[e.regs.a],regs[e.regs.b],regs[e.regs.c]); break;
+        case vm_enum2_SET: vm_shape_set(tp,curFrame,regs[e.regs.a],regs[e.regs.b],regs[e.regs.c]); break;
         case vm_enum2_DEL: vm_operations_dict_key_del(tp,regs[e.regs.a],regs[e.regs.b]); break;
         case vm_enum2_MOVE: regs[e.regs.a] = regs[e.regs.b]; break;
         case vm_enum2_NUMBER:
@@ -421,7 +448,10 @@ void vm_regbuiltins(type_vm *tp) {
     {"mtime",vm_api_mtime}, {"number",vm_api_type_float}, {"round",vm_api_math_round},
     {"ord",vm_string_ord}, {"merge",vm_dict_merge}, {"getraw",vm_api_getraw},
     {"setmeta",vm_api_setmeta}, {"getmeta",vm_api_getmeta},
-    {"bool", vm_api_type_bool},
+    {"bool", vm_api_type_bool}, {"clock",vm_api_clock}, {"builder",vm_string_builder},
+    {"repr",vm_api_string_repr}, {"parse_numbers",vm_api_parse_numbers},
+    {"bytearray",vm_bytes_new}, {"deque",vm_deque_new}, {"set",vm_set_new}, {"sum",vm_api_stat_sum},
+    {"mean",vm_api_stat_mean}, {"dot",vm_api_stat_dot}, {"prefix_sum",vm_api_stat_prefix_sum},
     {0,0},
     };
     int i; for(i=0; b[i].s; i++) {
@@ -15,6 +15,12 @@
 #include <stdarg.h>
 #include <math.h>
 #include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #ifdef __GNUC__
 #define vm_inline __inline__
@@ -40,6 +46,11 @@ enum {
     vm_enum2_NOT, vm_enum2_BITNOT,
     vm_enum2_TOTAL
 };
+/* Magic numbers of the built in data objects, see <vm_misc_dataObj>. */
+enum {
+    vm_enum3_none,vm_enum3_builder,vm_enum3_bytes,vm_enum3_deque,
+    vm_enum3_ndarray,vm_enum3_set,
+};
 
 typedef double type_vmNum;
 
@@ -108,23 +119,100 @@ typedef union type_vmObj {
     type_vmStructData data;
 } type_vmObj;
 
+/* Type: type_vmString
+ * Storage shared by a string and all the views into it.
+ *
+ * Fields:
+ * len - Number of bytes of s in use.
+ * alloc - Capacity of s, see <vm_string_concat>.
+ * uindex - Code point counts of s by block, built on demand, see
+ *          <vm_string_uleads>.
+ * ublocks - Number of entries in uindex.
+ */
 typedef struct type_vmString {
     int gci;
     int len;
+    int alloc;
+    int *uindex;
+    int ublocks;
     char s[1];
 } type_vmString;
+/* Type: type_vmBuilder
+ * Growable string buffer.
+ *
+ * Fields:
+ * info - String storage with room for alloc bytes, 0 while empty.
+ * len - Number of bytes written so far.
+ */
+typedef struct type_vmBuilder {
+    type_vmString *info;
+    int len;
+    int alloc;
+} type_vmBuilder;
+/* Type: type_vmList
+ *
+ * Fields:
+ * items - The first item. Room for front more items is kept before it.
+ * alloc - Number of items there is room for from items on.
+ * front - Free slots before items, see <vm_list_pop>.
+ * pinned - Set on the register and parameter lists. Their strings may
+ *          also be held in C locals, so <vm_gc_compact> leaves them alone,
+ *          and they are never packed.
+ * nums - Set while the list is packed, see <vm_list_fit>. It then takes
+ *        the place of items.
+ * share - Set while the storage is shared with slices, see <vm_list_slice>.
+ */
 typedef struct type_vmList {
     int gci;
     type_vmObj *items;
     int len;
     int alloc;
+    int front;
+    int pinned;
+    type_vmNum *nums;
+    struct type_vmShare *share;
 } type_vmList;
+/* Type: type_vmShare
+ * Storage of a list shared by the lists viewing it.
+ *
+ * Fields:
+ * refs - Number of lists using the storage.
+ * size - Number of items the storage has room for.
+ * cycle, lo, hi - Items lo to hi were followed in collector cycle cycle,
+ *                 see <vm_gc_follow>.
+ */
+typedef struct type_vmShare {
+    int refs;
+    int size;
+    int cycle;
+    int lo;
+    int hi;
+} type_vmShare;
 typedef struct type_vmItem {
     int used;
     int hash;
     type_vmObj key;
     type_vmObj val;
 } type_vmItem;
+/* Type: type_vmDict
+ * Compact, insertion-ordered hash table.
+ *
+ * Fields:
+ * items - Dense array of entries in insertion order. Deleted entries stay
+ *         behind as holes (used == 0) until the next resize.
+ * len - Number of live entries.
+ * alloc - Capacity of items.
+ * used - Number of items consumed so far, holes included.
+ * index - Open-addressed table of mask+1 control bytes followed by mask+1
+ *         slots holding indices into items. Slots are 8, 16 or 32 bits wide
+ *         depending on alloc, see <vm_dict_ixwidth>.
+ * shape - For objects, the <type_vmShape> describing the keys in items, or
+ *         0 once the dict no longer follows a shape.
+ * ismeta - Set once the dict has been used as another dict's meta.
+ * mcache - Lookup cache of a meta dict, vm_def_MCACHE entries or 0.
+ * atk, atn - Position k and entry n of the last <vm_dict_at> lookup, or -1,
+ *            so stepping through a dict with holes resumes from there.
+ */
 typedef struct type_vmDict {
     int gci;
     type_vmItem *items;
@@ -133,8 +221,51 @@ typedef struct type_vmDict {
     int curFrame;
     int mask;
     int used;
+    void *index;
     type_vmObj meta;
+    struct type_vmShape *shape;
+    int ismeta;
+    struct type_vmMcache *mcache;
+    int atk, atn;
 } type_vmDict;
+
+/* Type: type_vmMcache
+ * Entry of a meta dict's lookup cache, see <vm_api_lookup_meta>.
+ *
+ * Records whether key was found along the meta chain (and as what) while
+ * <type_vm>.meta_epoch was epoch.
+ */
+typedef struct type_vmMcache {
+    int epoch;
+    int hash;
+    int found;
+    type_vmObj key;
+    type_vmObj val;
+} type_vmMcache;
+
+/* Type: type_vmShape
+ * Shared description of an object's attribute layout.
+ *
+ * Objects that get the same string keys added in the same order share a
+ * shape, and every key sits in the same entry of their dicts. Shapes form
+ * a tree rooted at <type_vm>.shapes; adding a key moves an object to a
+ * child shape. Shapes are owned by the VM and live until <vm_deinit>.
+ *
+ * Fields:
+ * parent - The shape without the last key.
+ * child, next - First child and next sibling in the transition tree.
+ * len - Number of keys; the last key lives in entry len-1.
+ * hash, key, klen - The last key.
+ */
+typedef struct type_vmShape {
+    struct type_vmShape *parent;
+    struct type_vmShape *child;
+    struct type_vmShape *next;
+    int len;
+    int hash;
+    int klen;
+    char *key;
+} type_vmShape;
 typedef struct type_vmFnc {
     int gci;
     type_vmObj self;
@@ -165,10 +296,36 @@ typedef struct type_vmFrame {
     int cregs;
 } type_vmFrame;
 
+/* Type: type_vmCache
+ * Inline cache entry for a GET or SET instruction on an object.
+ *
+ * Remembers that the key at pc was found in entry slot of objects with
+ * this shape and meta, while no meta dict has changed since epoch.
+ */
+typedef struct type_vmCache {
+    type_vmCode *pc;
+    type_vmShape *shape;
+    type_vmDict *meta;
+    int epoch;
+    int slot;
+} type_vmCache;
+
 #define vm_def_GCMAX 4096
 #define vm_def_FRAMES 256
 #define vm_def_REGS_EXTRA 2
 #define vm_def_REGS 16384
+#define vm_def_CACHE 1024
+#define vm_def_SHAPE_MAX 64
+#define vm_def_MCACHE 32
+#define vm_def_COMPACT_PARENT 4096
+#define vm_def_COMPACT_RATIO 8
+#define vm_def_INTS 1024
+#define vm_def_STRS 256
+#define vm_def_STRS_LEN 24
+#define vm_def_UBLOCK 256
+#define vm_def_UINDEX_MIN 1024
+#define vm_def_LIST_FRONT 16
+#define vm_def_LIST_VIEW 16
 
 /* Type: type_vm
  * Representation of a interpreter virtual machine instance.
@@ -187,6 +344,11 @@ typedef struct type_vmFrame {
  * params - A list of parameters for the current function call.
  * frames - A list of all call frames.
  * curFrame - The index of the currently executing call frame.
+ * hash_seed - Random seed mixed into every dictionary hash.
+ * shapes - Root of the object shape tree, see <type_vmShape>.
+ * meta_epoch - Bumped whenever a dict used as a meta changes.
+ * cache - Inline caches for GET and SET, indexed by instruction address.
+ * strs - Recently formatted number strings, see <vm_string_number>.
  * frames[n].globals - A dictionary of global sybmols in callframe n.
  */
 typedef struct type_vm {
@@ -202,12 +364,21 @@ typedef struct type_vm {
     int jmp;
     type_vmObj ex;
     char chars[256][2];
+    char ints[vm_def_INTS][5];
+    type_vmObj strs_sub;
+    type_vmObj *strs;
     int curFrame;
+    unsigned int hash_seed;
+    /* shapes */
+    type_vmShape *shapes;
+    int meta_epoch;
+    type_vmCache cache[vm_def_CACHE];
     /* gc */
     type_vmList *white;
     type_vmList *grey;
     type_vmList *black;
     int steps;
+    int cycles;
     /* sandbox */
     clock_t clocks;
     double time_elapsed;
@@ -219,9 +390,33 @@ typedef struct type_vm {
 
 
 
+/* Type: vm_type_data
+ * Per object information of a data object.
+ *
+ * Fields:
+ * free - Called when the object is collected.
+ * get - Handles self[k] and method lookups, see <vm_operations_get>.
+ * set - Handles self[k] = v.
+ * len - Handles len(self).
+ * str - Handles str(self).
+ * follow - Greys the objects self refers to, see <vm_gc_follow>. Data
+ *          objects without it are never scanned by the collector.
+ * arith - Handles a op b for op one of vm_enum2_ADD, SUB, MUL, DIV, BITAND,
+ *         BITOR or BITXOR when a or b is self and the operation is not
+ *         otherwise defined.
+ * has - Handles k in self, see <vm_operations_haskey>.
+ * Any of these may be 0.
+ */
 typedef struct vm_type_data {
     int gci;
     void (*free)(type_vm *tp,type_vmObj);
+    type_vmObj (*get)(type_vm *tp,type_vmObj,type_vmObj);
+    void (*set)(type_vm *tp,type_vmObj,type_vmObj,type_vmObj);
+    type_vmObj (*len)(type_vm *tp,type_vmObj);
+    type_vmObj (*str)(type_vm *tp,type_vmObj);
+    void (*follow)(type_vm *tp,type_vmObj);
+    type_vmObj (*arith)(type_vm *tp,int op,type_vmObj a,type_vmObj b);
+    int (*has)(type_vm *tp,type_vmObj self,type_vmObj k);
 } vm_type_data;
 
 
@@ -237,6 +432,7 @@ type_vmObj vm_operations_get(type_vm *tp,type_vmObj,type_vmObj);
 type_vmObj vm_operations_haskey(type_vm *tp,type_vmObj self, type_vmObj k);
 type_vmObj vm_operations_len(type_vm *tp,type_vmObj);
 void vm_operations_dict_key_del(type_vm *tp,type_vmObj,type_vmObj);
+type_vmObj vm_operations_iterate(type_vm *tp,type_vmObj,type_vmObj);
 type_vmObj vm_operations_str(type_vm *tp,type_vmObj);
 int vm_operations_bool(type_vm *tp,type_vmObj);
 int vm_operations_cmp(type_vm *tp,type_vmObj,type_vmObj);
@@ -245,7 +441,10 @@ type_vmObj vm_string_printf(type_vm *tp,char const *fmt,...);
 type_vmObj vm_gc_track(type_vm *tp,type_vmObj);
 void vm_gc_grey(type_vm *tp,type_vmObj);
 type_vmObj vm_call_sub(type_vm *tp, type_vmObj fnc, type_vmObj params);
+type_vmObj vm_misc_params_v(type_vm *tp,int n,...);
 type_vmObj vm_operations_add(type_vm *tp,type_vmObj a, type_vmObj b) ;
+type_vmShape *vm_shape_add(type_vmShape *self, int hash, type_vmObj k);
+void vm_shape_meta(type_vm *tp, type_vmDict *self, type_vmObj meta);
 
 
 
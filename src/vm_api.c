@@ -8,9 +8,7 @@
 type_vmObj vm_api_bind(type_vm *tp) {
     type_vmObj r = vm_typecheck(tp,vm_enum1_fnc,vm_operations_get(tp,tp->params,vm_none));
     type_vmObj self = vm_operations_get(tp,tp->params,vm_none);
-    return vm_misc_fnc_new(tp,
-        r.fnc.ftype|2,r.fnc.cfnc,r.fnc.info->code,
-        self,r.fnc.info->globals);
+    return vm_misc_bind(tp,r,self);
 }
 
 #include "vm_api/vm_api_stat.c"
@@ -118,26 +116,58 @@ type_vmObj vm_api_mtime(type_vm *tp) {
 	return vm_none;
 }
 
-int vm_api_lookup_sub(type_vm *tp,type_vmObj self, type_vmObj k, type_vmObj *meta, int depth) {
-    int n = vm_dict_find_sub(tp,self.dict.val,k);
+/* Function: vm_api_clock
+ * Processor time used so far, in seconds.
+ */
+type_vmObj vm_api_clock(type_vm *tp) {
+    return vm_create_numericObj((type_vmNum)clock()/CLOCKS_PER_SEC);
+}
+
+int vm_api_lookup_meta(type_vm *tp,type_vmObj self, int hash, type_vmObj k, type_vmObj *meta, int depth);
+
+int vm_api_lookup_sub(type_vm *tp,type_vmObj self, int hash, type_vmObj k, type_vmObj *meta, int depth) {
+    int n = vm_dict_hash_find_sub(tp,self.dict.val,hash,k);
     if (n != -1) {
         *meta = self.dict.val->items[n].val;
         return 1;
     }
     depth--; if (!depth) { vm_raise(0,vm_string("(interpreter_lookup) RuntimeError: maximum lookup depth exceeded")); }
-    if (self.dict.dtype && self.dict.val->meta.type == vm_enum1_dict && vm_api_lookup_sub(tp,self.dict.val->meta,k,meta,depth)) {
+    if (self.dict.dtype && self.dict.val->meta.type == vm_enum1_dict && vm_api_lookup_meta(tp,self.dict.val->meta,hash,k,meta,depth)) {
         if (self.dict.dtype == 2 && meta->type == vm_enum1_fnc) {
-            *meta = vm_misc_fnc_new(tp,meta->fnc.ftype|2,
-                meta->fnc.cfnc,meta->fnc.info->code,
-                self,meta->fnc.info->globals);
+            *meta = vm_misc_bind(tp,*meta,self);
         }
         return 1;
     }
     return 0;
 }
 
+/* Function: vm_api_lookup_meta
+ * Looks k up along a meta chain, starting at the meta dict self.
+ *
+ * Results, including misses, are remembered in the meta's own mcache
+ * until <type_vm>.meta_epoch moves, i.e. until any meta dict changes.
+ */
+int vm_api_lookup_meta(type_vm *tp,type_vmObj self, int hash, type_vmObj k, type_vmObj *meta, int depth) {
+    type_vmDict *d = self.dict.val;
+    type_vmMcache *c;
+    if (!d->ismeta || self.dict.dtype == 2) { return vm_api_lookup_sub(tp,self,hash,k,meta,depth); }
+    if (!d->mcache) { d->mcache = (type_vmMcache*)calloc(vm_def_MCACHE*sizeof(type_vmMcache),1);/*calloc((x),1)*/ }
+    c = &d->mcache[hash&(vm_def_MCACHE-1)];
+    if (c->epoch == tp->meta_epoch && c->hash == hash && vm_operations_cmp(tp,c->key,k) == 0) {
+        if (c->found) { *meta = c->val; }
+        return c->found;
+    }
+    c->found = vm_api_lookup_sub(tp,self,hash,k,meta,depth);
+    c->epoch = tp->meta_epoch;
+    c->hash = hash;
+    c->key = k;
+    c->val = c->found ? *meta : vm_none;
+    vm_gc_grey(tp,c->key); vm_gc_grey(tp,c->val);
+    return c->found;
+}
+
 int vm_api_lookup(type_vm *tp,type_vmObj self, type_vmObj k, type_vmObj *meta) {
-    return vm_api_lookup_sub(tp,self,k,meta,8);
+    return vm_api_lookup_sub(tp,self,vm_dict_hash(tp,k),k,meta,8);
 }
 
 
@@ -166,7 +196,7 @@ int vm_api_lookup(type_vm *tp,type_vmObj self, type_vmObj k, type_vmObj *meta) {
 type_vmObj vm_api_setmeta(type_vm *tp) {
     type_vmObj self = vm_typecheck(tp,vm_enum1_dict,vm_operations_get(tp,tp->params,vm_none));
     type_vmObj meta = vm_typecheck(tp,vm_enum1_dict,vm_operations_get(tp,tp->params,vm_none));
-    self.dict.val->meta = meta;
+    vm_shape_meta(tp,self.dict.val,meta);
     return vm_none;
 }
 
@@ -185,13 +215,14 @@ type_vmObj vm_api_getmeta(type_vm *tp) {
 type_vmObj vm_api_object(type_vm *tp) {
     type_vmObj self = vm_dict_create(tp);
     self.dict.dtype = 2;
+    self.dict.val->shape = tp->shapes;
     return self;
 }
 
 type_vmObj vm_api_object_new(type_vm *tp) {
     type_vmObj klass = vm_typecheck(tp,vm_enum1_dict,vm_operations_get(tp,tp->params,vm_none));
     type_vmObj self = vm_api_object(tp);
-    self.dict.val->meta = klass;
+    vm_shape_meta(tp,self.dict.val,klass);
 			if (self.dict.dtype == 2) {
 					type_vmObj meta; 
 					if (vm_api_lookup(tp,self,vm_string("__init__"),&meta)) {
@@ -237,7 +268,7 @@ type_vmObj vm_api_getraw(type_vm *tp) {
  */
 type_vmObj vm_api_class(type_vm *tp) {
     type_vmObj klass = vm_dict_create(tp);
-    klass.dict.val->meta = vm_operations_get(tp,tp->builtins,vm_string("object")); 
+    vm_shape_meta(tp,klass.dict.val,vm_operations_get(tp,tp->builtins,vm_string("object")));
     return klass;
 }
 
@@ -1,19 +1,49 @@
+/* Function: vm_api_number
+ * Converts string v to a number the way float() does.
+ *
+ * Plain decimals take <vm_string_parse>. Everything else, including
+ * prefixed or octal integers and integers in base ord, goes to strtod or
+ * strtol as before.
+ */
+type_vmNum vm_api_number(type_vm *tp, type_vmObj v, int ord) {
+    char b[64], *s = b;
+    type_vmNum r;
+    if (!ord && vm_string_parse(v.string.val,v.string.len,&r)) { return r; }
+    if (v.string.len >= (int)sizeof(b)) { s = (char*)malloc(v.string.len+1); }
+    memcpy(s,v.string.val,v.string.len);
+    s[v.string.len] = 0;
+    if (!ord && (strchr(s,'.') || strchr(s,'e') || strchr(s,'E'))) { r = strtod(s,0); }
+    else { r = strtol(s,0,ord); }
+    if (s != b) { free(s); }
+    return r;
+}
 
 type_vmObj vm_api_type_float(type_vm *tp) {
     type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
     int ord = vm_macros_DEFAULT(vm_create_numericObj(0)).number.val;
     int type = v.type;
     if (type == vm_enum1_number) { return v; }
-    if (type == vm_enum1_string && v.string.len < 32) {
-        char s[32]; memset(s,0,v.string.len+1);
-        memcpy(s,v.string.val,v.string.len);
-        if (strchr(s,'.')) { return vm_create_numericObj(atof(s)); }
-        return(vm_create_numericObj(strtol(s,0,ord)));
-    }
+    if (type == vm_enum1_string) { return vm_create_numericObj(vm_api_number(tp,v,ord)); }
     vm_raise(tp,vm_string("(vm_api_type_float) TypeError: ?"));
 	return vm_none;
 }
 
+/* Function: vm_api_parse_numbers
+ * parse_numbers(list) converts a list of strings to a list of numbers.
+ */
+type_vmObj vm_api_parse_numbers(type_vm *tp) {
+    type_vmObj v = vm_typecheck(tp,vm_enum1_list,vm_operations_get(tp,tp->params,vm_none));
+    type_vmObj r = vm_list(tp);
+    int i;
+    vm_list_realloc(tp,r.list.val,v.list.val->len);
+    for (i=0; i<v.list.val->len; i++) {
+        type_vmObj e = vm_list_at(v.list.val,i);
+        if (e.type == vm_enum1_string) { e = vm_create_numericObj(vm_api_number(tp,e,0)); }
+        vm_list_appendx(tp,r.list.val,vm_typecheck(tp,vm_enum1_number,e));
+    }
+    return r;
+}
+
 type_vmObj vm_api_math_abs(type_vm *tp) {
     return vm_create_numericObj(fabs(vm_api_type_float(tp).number.val));
 }
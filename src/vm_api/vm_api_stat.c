@@ -1,16 +1,180 @@
-type_vmObj vm_api_stat_min(type_vm *tp) {
-    type_vmObj r = vm_operations_get(tp,tp->params,vm_none);
-    type_vmObj e;
-    interpreter_LOOP(e)
-        if (vm_operations_cmp(tp,r,e) > 0) { r = e; }
-    interpreter_END;
+/* Kernels over packed number lists, see <vm_list_fit>. With SSE2 they work
+ * on two lanes of two doubles, so sums of non-integral numbers may round
+ * differently from adding left to right. */
+
+type_vmNum vm_api_stat_sumd(type_vmNum const *v, int n) {
+    type_vmNum r = 0;
+    int i = 0;
+#ifdef __SSE2__
+    __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+    double t[2];
+    for (; i+4 <= n; i += 4) {
+        a = _mm_add_pd(a,_mm_loadu_pd(v+i));
+        b = _mm_add_pd(b,_mm_loadu_pd(v+i+2));
+    }
+    _mm_storeu_pd(t,_mm_add_pd(a,b));
+    r = t[0]+t[1];
+#endif
+    for (; i<n; i++) { r += v[i]; }
+    return r;
+}
+
+type_vmNum vm_api_stat_dotd(type_vmNum const *x, type_vmNum const *y, int n) {
+    type_vmNum r = 0;
+    int i = 0;
+#ifdef __SSE2__
+    __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+    double t[2];
+    for (; i+4 <= n; i += 4) {
+        a = _mm_add_pd(a,_mm_mul_pd(_mm_loadu_pd(x+i),_mm_loadu_pd(y+i)));
+        b = _mm_add_pd(b,_mm_mul_pd(_mm_loadu_pd(x+i+2),_mm_loadu_pd(y+i+2)));
+    }
+    _mm_storeu_pd(t,_mm_add_pd(a,b));
+    r = t[0]+t[1];
+#endif
+    for (; i<n; i++) { r += x[i]*y[i]; }
+    return r;
+}
+
+/* Smallest of n > 0 doubles, or the largest if max is set. */
+type_vmNum vm_api_stat_mind(type_vmNum const *v, int n, int max) {
+    type_vmNum r = v[0];
+    int i = 0;
+#ifdef __SSE2__
+    if (n >= 2) {
+        __m128d a = _mm_loadu_pd(v);
+        double t[2];
+        for (i=2; i+2 <= n; i += 2) {
+            a = max ? _mm_max_pd(a,_mm_loadu_pd(v+i)) : _mm_min_pd(a,_mm_loadu_pd(v+i));
+        }
+        _mm_storeu_pd(t,a);
+        r = (max ? t[1] > t[0] : t[1] < t[0]) ? t[1] : t[0];
+    }
+#endif
+    for (; i<n; i++) {
+        if (max ? v[i] > r : v[i] < r) { r = v[i]; }
+    }
+    return r;
+}
+
+/* The list or other sequence min, max and the like work on: the only
+ * parameter when it is one, otherwise the parameters themselves. */
+static type_vmObj vm_api_stat_seq(type_vm *tp) {
+    type_vmObj v = tp->params;
+    if (v.list.val->len == 1) {
+        type_vmObj e = vm_list_at(v.list.val,0);
+        if (e.type == vm_enum1_list || e.type == vm_enum1_data) { v = e; }
+    }
+    return v;
+}
+
+/* Item n of v, see <vm_api_stat_seq>. */
+static type_vmObj vm_api_stat_item(type_vm *tp, type_vmObj v, int n) {
+    if (v.type == vm_enum1_list) { return vm_list_at(v.list.val,n); }
+    return vm_operations_get(tp,v,vm_create_numericObj(n));
+}
+
+static type_vmObj vm_api_stat_extreme(type_vm *tp, int max) {
+    type_vmObj v = vm_api_stat_seq(tp);
+    type_vmObj r, e;
+    int n = vm_operations_len(tp,v).number.val, i;
+    if (!n) {
+        vm_raise(tp,vm_string("(vm_api_stat_extreme) ValueError: min() or max() of an empty sequence"));
+    }
+    if (v.type == vm_enum1_list && v.list.val->nums) {
+        return vm_create_numericObj(vm_api_stat_mind(v.list.val->nums,n,max));
+    }
+    r = vm_api_stat_item(tp,v,0);
+    for (i=1; i<n; i++) {
+        e = vm_api_stat_item(tp,v,i);
+        if (max ? vm_operations_cmp(tp,r,e) < 0 : vm_operations_cmp(tp,r,e) > 0) { r = e; }
+    }
     return r;
 }
+
+/* Function: vm_api_stat_min
+ * min(seq) or min(a,b,...) returns the smallest item.
+ *
+ * seq is a list or a sequence type such as deque or bytearray.
+ */
+type_vmObj vm_api_stat_min(type_vm *tp) {
+    return vm_api_stat_extreme(tp,0);
+}
+
+/* Function: vm_api_stat_max
+ * max(seq) or max(a,b,...) returns the largest item.
+ */
 type_vmObj vm_api_stat_max(type_vm *tp) {
-    type_vmObj r = vm_operations_get(tp,tp->params,vm_none);
-    type_vmObj e;
-    interpreter_LOOP(e)
-        if (vm_operations_cmp(tp,r,e) < 0) { r = e; }
-    interpreter_END;
+    return vm_api_stat_extreme(tp,1);
+}
+
+/* Function: vm_api_stat_sum
+ * sum(seq[,start]) adds the items of seq to start, 0 by default.
+ */
+type_vmObj vm_api_stat_sum(type_vm *tp) {
+    type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj r = vm_macros_DEFAULT(vm_create_numericObj(0));
+    int n = vm_operations_len(tp,v).number.val, i;
+    if (v.type == vm_enum1_list && v.list.val->nums && r.type == vm_enum1_number) {
+        return vm_create_numericObj(r.number.val+vm_api_stat_sumd(v.list.val->nums,n));
+    }
+    for (i=0; i<n; i++) { r = vm_operations_add(tp,r,vm_api_stat_item(tp,v,i)); }
+    return r;
+}
+
+/* Function: vm_api_stat_mean
+ * mean(seq) is the arithmetic mean of a non-empty sequence of numbers.
+ */
+type_vmObj vm_api_stat_mean(type_vm *tp) {
+    type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
+    int n = vm_operations_len(tp,v).number.val, i;
+    type_vmNum r = 0;
+    if (!n) {
+        vm_raise(tp,vm_string("(vm_api_stat_mean) ValueError: mean() of an empty sequence"));
+    }
+    if (v.type == vm_enum1_list && v.list.val->nums) {
+        r = vm_api_stat_sumd(v.list.val->nums,n);
+    } else {
+        for (i=0; i<n; i++) { r += vm_typecheck(tp,vm_enum1_number,vm_api_stat_item(tp,v,i)).number.val; }
+    }
+    return vm_create_numericObj(r/n);
+}
+
+/* Function: vm_api_stat_dot
+ * dot(a,b) is the sum of the products of the items of two sequences of
+ * numbers of the same length.
+ */
+type_vmObj vm_api_stat_dot(type_vm *tp) {
+    type_vmObj a = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj b = vm_operations_get(tp,tp->params,vm_none);
+    int n = vm_operations_len(tp,a).number.val, i;
+    type_vmNum r = 0;
+    if (n != vm_operations_len(tp,b).number.val) {
+        vm_raise(tp,vm_string("(vm_api_stat_dot) ValueError: sequences differ in length"));
+    }
+    if (a.type == vm_enum1_list && a.list.val->nums && b.type == vm_enum1_list && b.list.val->nums) {
+        return vm_create_numericObj(vm_api_stat_dotd(a.list.val->nums,b.list.val->nums,n));
+    }
+    for (i=0; i<n; i++) {
+        r += vm_typecheck(tp,vm_enum1_number,vm_api_stat_item(tp,a,i)).number.val *
+            vm_typecheck(tp,vm_enum1_number,vm_api_stat_item(tp,b,i)).number.val;
+    }
+    return vm_create_numericObj(r);
+}
+
+/* Function: vm_api_stat_prefix_sum
+ * prefix_sum(seq) returns the list of running totals of seq.
+ */
+type_vmObj vm_api_stat_prefix_sum(type_vm *tp) {
+    type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
+    type_vmObj r = vm_list(tp);
+    int n = vm_operations_len(tp,v).number.val, i;
+    type_vmNum t = 0;
+    vm_list_realloc(tp,r.list.val,n);
+    for (i=0; i<n; i++) {
+        if (v.type == vm_enum1_list && v.list.val->nums) { t += v.list.val->nums[i]; }
+        else { t += vm_typecheck(tp,vm_enum1_number,vm_api_stat_item(tp,v,i)).number.val; }
+        vm_list_appendx(tp,r.list.val,vm_create_numericObj(t));
+    }
     return r;
 }
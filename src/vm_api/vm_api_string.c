@@ -2,3 +2,14 @@ type_vmObj vm_api_string_len(type_vm *tp) {
     type_vmObj e = vm_operations_get(tp,tp->params,vm_none);
     return vm_operations_len(tp,e);
 }
+
+/* Function: vm_api_string_repr
+ * repr(x) is str(x), except that numbers are written with as few digits
+ * as read back to exactly the same number.
+ */
+type_vmObj vm_api_string_repr(type_vm *tp) {
+    type_vmObj v = vm_operations_get(tp,tp->params,vm_none);
+    char b[32];
+    if (v.type != vm_enum1_number) { return vm_operations_str(tp,v); }
+    return vm_string_copy(tp,b,vm_string_shortest(b,v.number.val));
+}
@@ -0,0 +1,92 @@
+# insertion-ordered dict layout
+d = {}
+for i in range(1000):
+    d[i] = i * 2
+assert(len(d) == 1000)
+assert(d[777] == 1554)
+for i in range(0, 1000, 2):
+    del d[i]
+assert(len(d) == 500)
+assert(10 not in d)
+assert(d[11] == 22)
+
+order = []
+for k in d:
+    order.append(k)
+assert(order[0] == 1)
+assert(order[499] == 999)
+
+for i in range(1000, 3000):
+    d[i] = i
+assert(len(d) == 2500)
+n = 0
+for k in d:
+    for j in d:
+        n += 1
+    break
+assert(n == 2500)
+
+s = {"b": 1, "a": 2, "c": 3}
+keys = []
+for k in s:
+    keys.append(k)
+assert(",".join(keys) == "b,a,c")
+del s["a"]
+s["a"] = 4
+keys = []
+for k in s:
+    keys.append(k)
+assert(",".join(keys) == "b,c,a")
+c = copy(s)
+c["z"] = 1
+assert(len(c) - len(s) == 1)
+e = {}
+for i in range(10):
+    e[i] = i
+seen = []
+for k in e:
+    seen.append(k)
+    if k % 2 == 0:
+        del e[k]
+assert(seen == [0, 1, 2, 3, 4, 5, 6, 7, 8, 9])
+assert(len(e) == 5)
+assert(1 in e and 9 in e and 8 not in e)
+
+# dict methods
+m = {"x": 1, "y": 2}
+assert(",".join(m.keys()) == "x,y")
+assert(m.values()[1] == 2)
+assert(m.items()[0][0] + str(m.items()[0][1]) == "x1")
+assert(m.get("x") == 1)
+assert(m.get("q", 5) == 5)
+assert(m.get("q") == None)
+assert(m.setdefault("x", 9) == 1)
+assert(m.setdefault("z", 3) == 3)
+assert(m["z"] == 3)
+g = {}
+for i in range(100):
+    g.setdefault(i, i * 2)
+assert(len(g) + g[99] + g.setdefault(5, 0) == 100 + 198 + 10)
+assert(m.pop("z") == 3)
+assert("z" not in m)
+assert(m.pop("z", 7) == 7)
+ok = 0
+try:
+    m.pop("z")
+except:
+    ok = 1
+assert(ok)
+m.update({"y": 20, "w": 4})
+assert(",".join(m.keys()) + str(m["y"]) == "x,y,w20")
+m["items"] = "stored"
+assert(m["items"] == "stored")
+big = {}
+for i in range(500):
+    big[i] = i
+u = {}
+u.update(big)
+u.update(big)
+assert(len(u) == 500)
+merge(u, {"k": 1})
+assert(u["k"] == 1)
+print("02.py: ok")
@@ -0,0 +1,116 @@
+# attribute shapes and inline caches
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+    def norm1(self):
+        return self.x + self.y
+
+class Other:
+    def __init__(self, y):
+        self.y = y
+        self.x = y * 10
+
+def getx(o):
+    return o.x
+
+def setx(o, v):
+    o.x = v
+
+a = Point(1, 2)
+b = Point(3, 4)
+c = Other(5)
+n = 0
+for i in range(100):
+    n += getx(a) + getx(b) + getx(c)
+assert(n == 100 * (1 + 3 + 50))
+
+for i in range(10):
+    setx(a, i)
+assert(a.x == 9)
+assert(b.x == 3)
+
+del b.x
+assert("x" not in b)
+b.x = 7
+assert(getx(b) == 7)
+
+assert(a.norm1() == 11)
+def norm2(self):
+    return self.x * self.y
+Point.norm1 = norm2
+assert(a.norm1() == 18)
+
+def getter(self, k):
+    return "via __get__"
+Point.__get__ = getter
+assert(getx(a) == "via __get__")
+
+class Logged:
+    def __init__(self):
+        self.x = 0
+log = []
+def setter(self, k, v):
+    log.append(k)
+o = Logged()
+for i in range(3):
+    setx(o, i)
+Logged.__set__ = setter
+setx(o, 99)
+assert(len(log) == 1)
+
+class Base:
+    def __init__(self):
+        self.x = 1
+class Alt:
+    def kind(self):
+        return "alt"
+p = Base()
+getx(p)
+setmeta(p, Alt)
+assert(p.kind() == "alt")
+assert(getx(p) == 1)
+print("03.py: ok")
+
+# bound methods and meta chain lookups
+class Counter:
+    def __init__(self):
+        self.n = 0
+    def inc(self, by):
+        self.n = self.n + by
+        return self.n
+
+def make():
+    return Counter().inc
+
+m = make()
+junk = []
+for i in range(20000):
+    junk.append([i, str(i)])
+    if len(junk) > 100:
+        junk = []
+assert(m(2) == 2)
+assert(m(3) == 5)
+assert(istype(m, "method") == 1)
+k = Counter()
+assert(k.inc == k.inc)
+assert(k.inc != Counter().inc)
+def twice(self):
+    return self.n * 2
+t = bind(twice, k)
+k.inc(4)
+assert(t() == 8)
+
+class Derived(Counter):
+    def dec(self):
+        self.n = self.n - 1
+        return self.n
+d = Derived()
+d.inc(5)
+assert(d.dec() == 4)
+def inc10(self, by):
+    self.n = self.n + 10 * by
+    return self.n
+Counter.inc = inc10
+assert(d.inc(1) == 14)
+print("03.py: methods ok")
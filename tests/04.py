@@ -0,0 +1,139 @@
+# substring search
+seed = 12345
+def rand(n):
+    global seed
+    seed = (seed * 1103515245 + 12345) % 2147483648
+    return int(seed / 65536) % n
+
+def text(n, alphabet):
+    r = []
+    for i in range(n):
+        r.append(alphabet[rand(len(alphabet))])
+    return "".join(r)
+
+def naive(s, k):
+    i = 0
+    while i + len(k) <= len(s):
+        if s[i:i+len(k)] == k:
+            return i
+        i += 1
+    return -1
+
+for alphabet in ["ab", "abc", "abcdefgh"]:
+    for m in [1, 2, 3, 5, 16, 31, 32, 33, 40, 64]:
+        for t in range(6):
+            s = text(300, alphabet)
+            if t % 2:
+                k = text(m, alphabet)
+            else:
+                a = rand(300 - m)
+                k = s[a:a+m]
+            assert(s.find(k) == naive(s, k))
+
+s = "a" * 200 + "b" + "a" * 60
+assert(s.find("a" * 40 + "b") == 160)
+assert(("ab" * 100).find("ab" * 20 + "b") == -1)
+assert("abc".find("") == 0)
+assert("abc".find("abcd") == -1)
+assert("b" * 40 not in s)
+assert("xyzzy".index("zz") == 2)
+
+# split and replace
+assert("|".join("a,b,,c".split(",")) == "a|b||c")
+assert("|".join("a,b,,c".split(",", 1)) == "a|b,,c")
+assert(len("abcxabc".split("abc")) == 3)
+assert("|".join(("x" + "ab" * 20) .split("ab" * 20)) == "x|")
+assert("aaaa".replace("aa", "b") == "bb")
+assert("aaaa".replace("a", "xy", 2) == "xyxyaa")
+assert("abc".replace("", "-") == "-a-b-c-")
+assert("a--b--c".replace("--", "") == "abc")
+assert("abc".replace("z", "q") == "abc")
+ok = 0
+try:
+    "abc".split("")
+except:
+    ok = 1
+assert(ok)
+
+# builder and join
+b = builder()
+b.append("x = ")
+b.append(12)
+b.extend([";", " y"])
+assert(b.build() == "x = 12; y")
+assert(len(b) == 9)
+assert(str(b) == "x = 12; y")
+b.clear()
+assert(b.build() == "")
+for i in range(1000):
+    b.append(i % 10)
+assert(b.build() == "0123456789" * 100)
+assert(",".join([1, "a", None]) == "1,a,None")
+assert("-".join([]) == "")
+
+# concatenation onto the end of a string
+a = "x" * 200
+b = a + "p"
+c = a + "q"
+d = b + "r"
+e = b + "s"
+assert(b + c + d + e == a + "p" + a + "q" + a + "pr" + a + "ps")
+assert(a == "x" * 200)
+s = ""
+for i in range(300):
+    s = s + chr(65 + i % 26)
+t = s[0:10] + "!"
+assert(s[290:] == "EFGHIJKLMN")
+assert(t == "ABCDEFGHIJ!")
+assert(s[10] == "K")
+
+# small slices of large strings after collection
+big = "0123456789" * 2000
+keep = []
+d = {}
+for i in range(50):
+    keep.append(big[i*10:i*10+7])
+    d[big[i:i+5]] = big[i+1:i+4]
+big = None
+for i in range(20000):
+    junk = [str(i)]
+assert("".join(keep[0:3]) == "0123456" * 3)
+assert(d["34567"] == "456")
+assert(len(d) == 10)
+
+# numbers to strings
+assert(str(0) + str(7) + str(10) + str(999) + str(1023) == "07109991023")
+assert(str(1024) + " " + str(-1) + " " + str(-98765) + " " + str(123456789012) == "1024 -1 -98765 123456789012")
+assert(str(-5.5) + " " + str(0.125) == "-5.500000 0.125000")
+assert(str(0.1) + " " + str(2.0 / 3) + " " + str(-0.00001) == "0.100000 0.666667 -0.000010")
+assert(str(0.9999996) + " " + str(0 - 2.9999996) + " " + str(123456789.25) == "1.000000 -3.000000 123456789.250000")
+assert(str(0.0000015) + " " + str(0.0000025) + " " + str(1e20 / 3) == "0.000002 0.000003 33333333333333331968.000000")
+for i in range(1000):
+    assert(str(i / 4 + 1024.5) == str(i / 4 + 1024.5))
+    assert(str(-1024 - i) + str(i + 0.5) == "-" + str(1024 + i) + str(i) + ".500000")
+assert(str(5)[0] + str(12)[1] == "52")
+assert({str(3): 1}["3"] == 1)
+
+# strip, is*, lower/upper and count
+for pad in ["", " ", "\t\n \r", " " * 40, " \n" * 17]:
+    for body in ["", "x", "a b", "hello world " * 5 + "end"]:
+        s = pad + body + pad
+        r = s.strip()
+        assert(r == body)
+assert(("0123456789" * 3).isdigit() == 1)
+assert(("0123456789" * 3 + "a").isdigit() == 0)
+assert("".isdigit() == 0)
+assert(("abcXYZ" * 7).isalpha() == 1)
+assert(("abcXYZ" * 7 + "@").isalpha() == 0)
+assert(("[`{@" ).isalpha() == 0)
+assert((" \t\n\r" * 9).isspace() == 1)
+assert((" \t\n\r" * 9 + ".").isspace() == 0)
+assert(("Hello WORLD @[`{ " * 3).lower() == "hello world @[`{ " * 3)
+assert(("Hello world @[`{ " * 3).upper() == "HELLO WORLD @[`{ " * 3)
+assert("abc".lower() == "abc")
+assert("hello".translate("el", "ip") == "hippo")
+assert(("abcab" * 10).count("a") == 20)
+assert(("abcab" * 10).count("ab") == 20)
+assert("aaaa".count("aa") == 2)
+assert("abc".count("") == 4)
+print("04.py: ok")
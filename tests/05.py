@@ -0,0 +1,46 @@
+e = chr(0xc3) + chr(0xa9)
+euro = chr(0xe2) + chr(0x82) + chr(0xac)
+g = chr(0xf0) + chr(0x9f) + chr(0x98) + chr(0x80)
+s = "caf" + e + " " + euro + "5 " + g
+assert(s.ulen() == 9)
+assert(len(s) == 15)
+assert(s.uat(3) == e)
+assert(s.uat(-1) == g)
+assert(s.uat(5) == euro)
+assert(s.uslice(2, 6) == "f" + e + " " + euro)
+assert(s.uslice(5) == euro + "5 " + g)
+assert(s.uslice(-3, -1) == "5 ")
+assert("|".join(s.uchars()) == "c|a|f|" + e + "| |" + euro + "|5| |" + g)
+assert(s.isutf8() == 1)
+assert(("abc" * 30).isutf8() == 1)
+assert(s[0:4].isutf8() == 0)
+assert((chr(0xc0) + chr(0x80)).isutf8() == 0)
+assert((chr(0xed) + chr(0xa0) + chr(0x80)).isutf8() == 0)
+assert((chr(0xf4) + chr(0x90) + chr(0x80) + chr(0x80)).isutf8() == 0)
+assert(("a" * 40 + chr(0xff)).isutf8() == 0)
+big = (s + "xy") * 500
+assert(big.ulen() == 5500)
+ok = 1
+for i in range(0, 5500, 7):
+    c = big.uat(i)
+    if c != (s + "xy").uat(i % 11):
+        ok = 0
+assert(ok)
+assert(big.uat(-2) == "x")
+part = big[17:]
+assert(part.ulen() == 5489)
+assert(part.uat(0) == "c")
+assert(part.uslice(2, 6) == "f" + e + " " + euro)
+grow = "x" * 2000
+t = grow + e
+assert(t.ulen() == 2001)
+t = t + euro
+assert(t.ulen() == 2002)
+assert(t.uat(2001) == euro)
+try:
+    s.uat(9)
+    ok = 0
+except:
+    ok = 1
+assert(ok)
+print("05.py: ok")
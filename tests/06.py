@@ -0,0 +1,38 @@
+seed = 777
+def rand(n):
+    global seed
+    seed = (seed * 1103515245 + 12345) % 2147483648
+    return int(seed / 65536) % n
+bad = 0
+for i in range(20000):
+    d = str(rand(100000)) + "." + str(rand(1000000))
+    if rand(3) == 0:
+        d = d + "e" + str(rand(40) - 20)
+    if rand(2) == 0:
+        d = "-" + d
+    if float(d) != float(" " + d):
+        bad += 1
+        print(d)
+assert(bad == 0)
+assert(float("12345") == 12345)
+assert(float("-42") == -42)
+assert(float("010") == 8)
+assert(float("0x1f") == 31)
+assert(float("ff", 16) == 255)
+assert(float("0") == 0)
+assert(float("0.5") == 0.5)
+assert(1 / float("-0.0") < 0)
+assert(1 / float("0.0") > 0)
+assert(float("1e5") == 100000)
+assert(float("25e-1") == 2.5)
+assert(float("3.14159265358979323846264338327950288") == float(" 3.14159265358979323846264338327950288"))
+assert(float("12345678901234567") == 12345678901234567)
+assert(float("1.5abc") == 1.5)
+assert(int("7.9") == 7)
+assert(repr(0.1) == "0.1")
+assert(repr(2.25) + " " + repr(1.0/3) + " " + repr(100) + " " + repr(-1e300) == "2.25 0.3333333333333333 100 -1e+300")
+assert(float(repr(1.0/3)) == 1.0/3)
+x = parse_numbers(["1", "2.5", "-3e2", "0x10", 7])
+assert(x[0] + x[1] + x[2] + x[3] + x[4] == 1 + 2.5 - 300 + 16 + 7)
+assert(1 / parse_numbers(["-0"])[0] < 0)
+print("06.py: ok")
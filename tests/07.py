@@ -0,0 +1,85 @@
+b = bytearray(8)
+assert(b[0] + b[7] == 0)
+assert(len(b) == 8)
+b[1] = 255
+b[-1] = 7
+assert(b[1] * 1000 + b[7] == 255007)
+b.pack("<I", 0, 305419896)
+assert(b[0] * 1000 + b[3] == 120018)
+assert(b.unpack("<I", 0) == 305419896)
+b.pack(">h", 4, -2)
+assert(b[4] * 1000 + b[5] == 255254)
+assert(b.unpack(">h", 4) == -2)
+assert(b.unpack("<h", 4) == -257)
+assert(b.unpack("b", 5) == -2)
+assert(b.unpack("B", 5) == 254)
+b.pack("d", 0, 2.5)
+assert(b.unpack("d", 0) == 2.5)
+b.pack(">f", 4, -0.75)
+assert(b.unpack(">f", 4) == -0.75)
+
+s = bytearray("hello world")
+v = s[6:]
+assert(len(v) == 5)
+assert(v.string() == "world")
+v[0] = 87
+assert(s.string() == "hello World")
+assert(v[1:3].string() == "or")
+s.append(33)
+s.extend([32, 65])
+s.extend("BC")
+s.extend(s[0:5])
+assert(s.string() == "hello World! ABChello")
+e = bytearray()
+e.extend(e)
+assert(e.string() == "")
+assert(bytearray([104, 105]).string() == "hi")
+v.append(33)
+assert(v.string() == "World!")
+v[0] = 119
+assert(s.string()[6:11] == "World")
+f = bytearray("abcdef")
+t = f[2:]
+t.append(103)
+f.append(55)
+assert(f.string() + " " + t.string() == "abcdef7 cdefg")
+t[0] = 67
+assert(f[2] == 99)
+c = bytearray("xyz")
+h = c[0:2]
+h.append(53)
+assert(h.string() + " " + c.string() == "xy5 xyz")
+c.extend(c)
+assert(c.string() == "xyzxyz")
+
+ok = 0
+try:
+    b[8]
+except:
+    ok = 1
+assert(ok)
+ok = 0
+try:
+    b.unpack("I", 6)
+except:
+    ok = 1
+assert(ok)
+ok = 0
+try:
+    b[0] = 256
+except:
+    ok = 1
+assert(ok)
+for f, x in [["B", 300], ["B", -1], ["b", 128], ["b", -129], ["<H", 65536], ["<i", 2147483648]]:
+    ok = 0
+    try:
+        b.pack(f, 0, x)
+    except:
+        ok = 1
+    assert(ok)
+b.pack("B", 0, 255)
+b.pack("b", 1, -128)
+b.pack("<I", 2, 4294967295)
+assert(b.unpack("B", 0) + b.unpack("b", 1) == 127)
+assert(b.unpack("<I", 2) == 4294967295)
+print("07.py: ok")
@@ -0,0 +1,201 @@
+# pop(0) and insert(0) at the front of lists, and deque
+a = [1, 2, 3, 4, 5, 6]
+assert(a.pop(0) == 1)
+assert(a.pop(1) == 3)
+a.insert(0, 9)
+a.insert(1, 8)
+assert(a[0] * 10 + a[1] == 98)
+assert(len(a) == 6)
+assert(a[2] * 1000 + a[3] * 100 + a[4] * 10 + a[5] == 2456)
+n = 0
+while len(a):
+    n = n * 10 + a.pop(0)
+assert(n == 982456)
+a.append(1)
+assert(a[0] == 1)
+for i in range(1000):
+    a.insert(0, i)
+assert(a[0] + a[999] == 999)
+total = 0
+for i in range(500):
+    total += a.pop(0)
+a.append(7)
+assert(total + len(a) + a[len(a) - 1] == 374750 + 502 + 7)
+
+d = deque([1, 2])
+d.append(3)
+d.appendleft(0)
+assert(len(d) == 4)
+assert(d[0] * 1000 + d[1] * 100 + d[2] * 10 + d[-1] == 123)
+assert(d.popleft() == 0)
+assert(d.pop() == 3)
+d[0] = 5
+assert(d[0] == 5)
+for i in range(100):
+    d.appendleft(i)
+    d.append(i)
+assert(d[0] + d[len(d) - 1] + len(d) == 99 + 99 + 202)
+total = 0
+for x in d:
+    total += x
+assert(total == 4950 * 2 + 7)
+d.clear()
+assert(len(d) == 0)
+d.extend([4, 5])
+assert(d.popleft() + d.popleft() == 9)
+caught = 0
+try:
+    d.pop()
+except:
+    caught = 1
+assert(caught)
+
+# sort with key= and reverse=
+a = [5, 3, 9, 1, 3, 7, 2]
+a.sort()
+assert(a == [1, 2, 3, 3, 5, 7, 9])
+a.sort(reverse=True)
+assert(a == [9, 7, 5, 3, 3, 2, 1])
+w = ["pear", "fig", "apple", "kiwi", "banana", "date"]
+w.sort()
+assert(",".join(w) == "apple,banana,date,fig,kiwi,pear")
+w.sort(key=len)
+assert(",".join(w) == "fig,date,kiwi,pear,apple,banana")
+w.sort(key=len, reverse=True)
+assert(",".join(w) == "banana,apple,date,kiwi,pear,fig")
+m = ["b", 2, "a", 1]
+m.sort()
+assert(m == [1, 2, "a", "b"])
+pairs = []
+for i in range(300):
+    pairs.append([(i * 7919) % 10, i])
+def first(p):
+    return p[0]
+pairs.sort(key=first)
+ok = 1
+for i in range(1, 300):
+    p = pairs[i - 1]
+    q = pairs[i]
+    if p[0] > q[0] or (p[0] == q[0] and p[1] > q[1]):
+        ok = 0
+assert(ok)
+w = ["2", [3], "1"]
+caught = 0
+try:
+    w.sort(key=float)
+except:
+    caught = 1
+assert(caught)
+assert(w[0] + w[2] == "21")
+w[1] = "3"
+w.sort(key=float)
+assert(",".join(w) == "1,2,3")
+s = [str(i) + "x" for i in range(40)]
+def shrink(x):
+    if len(s) > 20:
+        s.pop()
+    return x
+caught = 0
+try:
+    s.sort(key=shrink)
+except:
+    caught = 1
+assert(caught)
+assert(len(s) == 20)
+
+# packed number lists
+p = []
+for i in range(40):
+    p.append(i * 0.5)
+assert(p[3] + p[-1] == 21)
+assert(p[2:5] == [1, 1.5, 2])
+assert(19.5 in p)
+q = p[:]
+q.sort(reverse=True)
+assert(q[0] * 100 + q[39] == 1950)
+assert(p[0] == 0)
+assert(p.pop(0) + p.pop(0) == 0.5)
+p.insert(0, 7)
+p[1] = "x"
+assert(p[1] + str(p[0]) == "x7")
+assert(p[2] + p[38] == 1.5 + 19.5)
+p.append(3)
+assert(p[39] == 3)
+e = []
+e.append("s")
+e.pop()
+e.append(1)
+e.append(2)
+assert(e[0] + e[1] == 3)
+e.insert(0, "y")
+assert(e[0] + str(e[2]) == "y2")
+assert(",".join([str(x) for x in [1, 2, 3]]) == "1,2,3")
+assert([1, 2, 3] == [1, 2, 3])
+assert(bytearray([104, 105]).string() == "hi")
+d = {}
+d[[1, 2, 3]] = 5
+assert(d[[1, 2, 3]] == 5)
+k = set([[1.5, 2], [1.5, 2], [3]])
+assert(len(k) == 2)
+assert([1.5, 2] in k)
+
+# slices sharing storage until written, and stepped slices
+s = []
+for i in range(100):
+    s.append("i" + str(i))
+v = s[1:]
+assert(len(v) == 99)
+assert(v[0] + v[-1] == "i1i99")
+w = v[1:]
+w[0] = "w"
+assert(v[1] + w[0] + s[2] == "i2wi2")
+v.append("end")
+assert(v[99] + str(len(s)) == "end100")
+s.pop(0)
+assert(w[1] + s[0] == "i3i1")
+c = copy(s)
+s[0] = "z"
+assert(c[0] + s[0] == "i1z")
+def total(xs):
+    if len(xs) == 0:
+        return 0
+    return len(xs[0]) + total(xs[1:])
+assert(total(s) == 287)
+n = []
+for i in range(40):
+    n.append(i)
+m = n[2:]
+n.append(99)
+m.append(7)
+assert(n[40] + m[38] == 106)
+assert(n[1:9:3] == [1, 4, 7])
+assert(n[5:0:-2] == [5, 3, 1])
+assert(n[::-1][0] + n[::-1][40] == 99)
+assert(s[::40] == ["z", "i41", "i81"])
+ok = 0
+try:
+    n[::0]
+except:
+    ok = 1
+assert(ok)
+
+# extend and + building lists in bulk
+x = [1, 2, 3]
+x.extend(x)
+assert(x == [1, 2, 3, 1, 2, 3])
+x.extend(["a", 4])
+assert(x == [1, 2, 3, 1, 2, 3, "a", 4])
+y = ["b"]
+y.extend([5, 6])
+assert(y == ["b", 5, 6])
+assert([1, 2] + ["c"] + [] == [1, 2, "c"])
+r = []
+for i in range(40):
+    r.append(i)
+z = []
+z.extend(r[20:])
+z.extend(["end"])
+assert(len(z) == 21)
+assert(z[0] + z[19] == 59)
+assert(z[20] == "end")
+print("08.py: ok")
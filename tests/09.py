@@ -0,0 +1,43 @@
+a = []
+for i in range(1, 102):
+    a.append(i)
+assert(sum(a) == 5151)
+assert(sum(a, 9) == 5160)
+assert(sum([]) == 0)
+assert(sum(["a", "b"], "") == "ab")
+assert(min(a) == 1)
+assert(max(a) == 101)
+assert(min(5, 2, 8) == 2)
+assert(max(5, 2, 8) == 8)
+a[50] = -7
+a[77] = 1000
+assert(min(a) == -7)
+assert(max(a) == 1000)
+assert(min(["pear", "fig", "kiwi"]) == "fig")
+assert(max(deque([3, 9, 4])) == 9)
+assert(min(bytearray([7, 3, 5])) == 3)
+assert(mean([1, 2, 3, 4]) == 2.5)
+assert(dot([1, 2, 3], [4, 5, 6]) == 32)
+b = []
+c = []
+for i in range(10):
+    b.append(i)
+    c.append(2)
+assert(dot(b, c) == 90)
+assert(dot([1, 2], deque([3, 4])) == 11)
+p = prefix_sum([1, 2, 3, 4, 5])
+assert(p[0] * 10000 + p[2] * 100 + p[4] == 10615)
+assert(len(prefix_sum([])) == 0)
+caught = 0
+try:
+    min([])
+except:
+    caught = 1
+assert(caught)
+caught = 0
+try:
+    dot([1], [1, 2])
+except:
+    caught = 1
+assert(caught)
+print("09.py: ok")
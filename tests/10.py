@@ -0,0 +1,52 @@
+import ndarray
+
+a = ndarray.array([1, 2, 3, 4, 5])
+assert(len(a) == 5)
+assert(a.dtype == "float64")
+assert(str(a) == "<ndarray float64 5>")
+assert(a[1] == 2)
+assert(a[-1] == 5)
+assert(a.sum() == 15)
+assert(a.mean() == 3)
+assert(a.min() == 1)
+assert(a.max() == 5)
+b = a + 1
+assert(b[0] == 2)
+assert((10 - a)[4] == 5)
+assert((a * b).sum() == 70)
+assert((a / 2)[2] == 1.5)
+assert(a.dot(b) == 70)
+s = a[1:3]
+assert(len(s) == 2)
+s[0] = 9
+assert(a[1] == 9)
+c = a.copy()
+c[0] = 100
+assert(a[0] == 1)
+assert(a.tolist()[1] == 9)
+n = 0
+for x in a:
+    n += x
+assert(n == 22)
+
+i = ndarray.arange(10, "int64")
+assert(i.dtype == "int64")
+assert(i.sum() == 45)
+assert((i + 2).dtype == "int64")
+assert((i * 0.5).dtype == "float64")
+assert((i / 2)[3] == 1.5)
+assert((i + ndarray.zeros(10)).dtype == "float64")
+assert(ndarray.zeros(3, dtype="int64").dtype == "int64")
+z = ndarray.zeros(7)
+z.fill(2)
+assert(z.sum() == 14)
+assert(ndarray.array(i)[9] == 9)
+assert((ndarray.arange(7) * ndarray.arange(7)).sum() == 91)
+
+ok = 0
+try:
+    a + ndarray.zeros(2)
+except:
+    ok = 1
+assert(ok)
+print("10.py: ok")
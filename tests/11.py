@@ -0,0 +1,61 @@
+def members(s):
+    r = []
+    for x in s:
+        r.append(x)
+    r.sort()
+    return ",".join([str(x) for x in r])
+
+s = set([3, 1, 3, "a", 1])
+assert(len(s) == 3)
+assert(str(s) == "<set 3>")
+assert(3 in s)
+assert(2 not in s)
+assert("a" in s)
+s.add(2)
+s.add(2)
+assert(members(s) == "1,2,3,a")
+s.remove("a")
+assert(members(s) == "1,2,3")
+ok = 0
+try:
+    s.remove(9)
+except:
+    ok = 1
+assert(ok)
+s.discard(9)
+s.discard(1)
+assert(members(s) == "2,3")
+assert(members(set("abca")) == "a,b,c")
+assert(members(set({"x": 1, "y": 2})) == "x,y")
+a = set([1, 2, 3, 4])
+b = set([3, 4, 5])
+assert(members(a | b) == "1,2,3,4,5")
+assert(members(a & b) == "3,4")
+assert(members(a - b) == "1,2")
+assert(members(a ^ b) == "1,2,5")
+assert(members(a.union([9])) == "1,2,3,4,9")
+assert(members(b.intersection(a)) == "3,4")
+assert(members(b.difference(a)) == "5")
+c = a.copy()
+c.update(b)
+assert(members(a) == "1,2,3,4")
+assert(members(c) == "1,2,3,4,5")
+c.clear()
+assert(len(c) == 0)
+c.add("z")
+assert(members(c) == "z")
+big = set()
+for i in range(10000):
+    big.add(i * 2)
+n = 0
+for i in range(20000):
+    if i in big:
+        n += 1
+assert(n == 10000)
+ok = 0
+try:
+    a | [1]
+except:
+    ok = 1
+assert(ok)
+print("11.py: ok")
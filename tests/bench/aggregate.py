@@ -0,0 +1,24 @@
+a = []
+b = []
+for i in range(1000000):
+    a.append(i * 0.5)
+    b.append(2)
+t0 = clock()
+s = 0
+for x in a:
+    s += x
+lo = a[0]
+for x in a:
+    if x < lo:
+        lo = x
+t1 = clock()
+print("loop sum/min " + str(s) + " " + str(lo) + ": " + str(t1 - t0))
+t0 = clock()
+s = sum(a)
+lo = min(a)
+hi = max(a)
+d = dot(a, b)
+m = mean(a)
+p = prefix_sum(a)
+t1 = clock()
+print("builtins sum/min/max/dot/mean/prefix_sum " + str(s) + " " + str(d) + ": " + str(t1 - t0))
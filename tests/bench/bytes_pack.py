@@ -0,0 +1,21 @@
+n = 100000
+t0 = clock()
+b = bytearray(n * 4)
+for i in range(n):
+    b.pack("<I", i * 4, i)
+total = 0
+for i in range(n):
+    total += b.unpack("<I", i * 4)
+t1 = clock()
+print("bytearray pack/unpack " + str(total) + ": " + str(t1 - t0))
+t0 = clock()
+parts = []
+for i in range(n):
+    parts.append(chr(i % 256) + chr(int(i / 256) % 256) + chr(int(i / 65536) % 256) + chr(0))
+s = "".join(parts)
+total = 0
+for i in range(n):
+    j = i * 4
+    total += ord(s[j]) + ord(s[j + 1]) * 256 + ord(s[j + 2]) * 65536
+t1 = clock()
+print("strings and chr/ord " + str(total) + ": " + str(t1 - t0))
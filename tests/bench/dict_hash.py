@@ -0,0 +1,42 @@
+# Dict hashing on adversarial key sets.
+#
+# Each set is timed next to a set of ordinary keys of the same size. With a
+# weak hash the adversarial sets degrade to linear probing over every key.
+#
+#   buildout/sparrow tests/bench/dict_hash.py
+
+N = 20000
+
+def pad(s, n):
+    return s + "x" * (n - len(s))
+
+def fill(keys):
+    t = clock()
+    d = {}
+    for k in keys:
+        d[k] = 1
+    for k in keys:
+        d[k]
+    return clock() - t
+
+def report(name, plain, hostile):
+    a = fill(plain)
+    b = fill(hostile)
+    print(name, "plain:", a, "adversarial:", b)
+
+# Long keys that only differ in bytes a sampling hash skips over.
+prefix = "x" * 500
+plain = []
+hostile = []
+for i in range(N):
+    plain.append(pad(str(i) + prefix, 1024))
+    hostile.append(pad(prefix + str(100000 + i), 1024))
+report("long keys, shared prefix", plain, hostile)
+
+# Short keys sharing their first four bytes.
+plain = []
+hostile = []
+for i in range(N):
+    plain.append(str(i) + "abcd")
+    hostile.append("abcd" + str(i))
+report("short keys, shared head", plain, hostile)
@@ -0,0 +1,21 @@
+d = {}
+for i in range(100000):
+    d["k" + str(i)] = i
+t0 = clock()
+s = 0
+for k in d:
+    s += d[k]
+t1 = clock()
+print("key then lookup " + str(s) + ": " + str(t1 - t0))
+t0 = clock()
+s = 0
+for v in d.values():
+    s += v
+t1 = clock()
+print("values() " + str(s) + ": " + str(t1 - t0))
+t0 = clock()
+for i in range(20):
+    u = {}
+    merge(u, d)
+t1 = clock()
+print("merge into empty x20 " + str(len(u)) + ": " + str(t1 - t0))
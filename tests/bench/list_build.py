@@ -0,0 +1,19 @@
+a = []
+for i in range(1000):
+    a.append("s" + str(i))
+t0 = clock()
+n = 0
+for i in range(2000):
+    b = []
+    b.extend(a)
+    b.extend(a)
+    c = a + b
+    n += len(c)
+t1 = clock()
+print("extend and + " + str(n) + ": " + str(t1 - t0))
+t0 = clock()
+for i in range(300000):
+    d = [i, i, i, i, i, i, i, i]
+    e = [a, a, a, a, a, a, a, a]
+t1 = clock()
+print("list literals: " + str(t1 - t0))
@@ -0,0 +1,17 @@
+xs = []
+for i in range(20000):
+    xs.append("s" + str(i))
+t0 = clock()
+n = 0
+rest = xs
+while len(rest):
+    n += len(rest[0])
+    rest = rest[1:]
+t1 = clock()
+print("xs[1:] walk " + str(n) + ": " + str(t1 - t0))
+t0 = clock()
+n = 0
+for i in range(200):
+    n += len(copy(xs)) + len(xs[::2])
+t1 = clock()
+print("copy and step " + str(n) + ": " + str(t1 - t0))
@@ -0,0 +1,23 @@
+import math
+n = 1000000
+a = []
+for i in range(n):
+    a.append(i * 0.001)
+t0 = clock()
+r = []
+for x in a:
+    r.append(math.sin(x))
+t1 = clock()
+print("sin per item " + str(len(r)) + ": " + str(t1 - t0))
+t0 = clock()
+r = math.sin(a)
+t1 = clock()
+print("sin over list " + str(len(r)) + ": " + str(t1 - t0))
+t0 = clock()
+r = math.sqrt(a)
+t1 = clock()
+print("sqrt over list " + str(len(r)) + ": " + str(t1 - t0))
+t0 = clock()
+r = math.fabs(a)
+t1 = clock()
+print("fabs over list " + str(len(r)) + ": " + str(t1 - t0))
@@ -0,0 +1,22 @@
+import ndarray
+
+a = []
+b = []
+for i in range(1000000):
+    a.append(i * 0.5)
+    b.append(2)
+t0 = clock()
+c = []
+for i in range(len(a)):
+    c.append(a[i] * b[i] + 1)
+s = 0
+for x in c:
+    s += x
+t1 = clock()
+print("loop a*b+1 sum " + str(s) + ": " + str(t1 - t0))
+x = ndarray.array(a)
+y = ndarray.array(b)
+t0 = clock()
+s = (x * y + 1).sum()
+t1 = clock()
+print("ndarray a*b+1 sum " + str(s) + ": " + str(t1 - t0))
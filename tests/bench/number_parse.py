@@ -0,0 +1,23 @@
+row = "12.5,3.25,-7,100,0.001,42.75,9,1e3"
+rows = []
+for i in range(20000):
+    rows.append(row)
+t0 = clock()
+total = 0
+for r in rows:
+    for f in r.split(","):
+        total += float(f)
+t1 = clock()
+print("float() " + str(total) + ": " + str(t1 - t0))
+t0 = clock()
+total = 0
+for r in rows:
+    for f in parse_numbers(r.split(",")):
+        total += f
+t1 = clock()
+print("parse_numbers " + str(total) + ": " + str(t1 - t0))
+t0 = clock()
+for i in range(100000):
+    s = repr(i / 7)
+t1 = clock()
+print("repr(float) x100000: " + str(t1 - t0))
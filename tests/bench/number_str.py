@@ -0,0 +1,21 @@
+n = 300000
+t0 = clock()
+for i in range(n):
+    s = str(i % 1000)
+t1 = clock()
+print("str(small int): " + str(t1 - t0))
+t0 = clock()
+for i in range(n):
+    s = str(i * 7919)
+t1 = clock()
+print("str(int): " + str(t1 - t0))
+t0 = clock()
+for i in range(n):
+    s = str(i / 8)
+t1 = clock()
+print("str(float): " + str(t1 - t0))
+t0 = clock()
+for i in range(n):
+    s = "item " + str(i) + ": " + str(i % 100)
+t1 = clock()
+print("concatenate numbers: " + str(t1 - t0))
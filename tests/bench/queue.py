@@ -0,0 +1,19 @@
+n = 100000
+t0 = clock()
+a = []
+for i in range(n):
+    a.append(i)
+total = 0
+while len(a):
+    total += a.pop(0)
+t1 = clock()
+print("list pop(0) " + str(total) + ": " + str(t1 - t0))
+t0 = clock()
+d = deque()
+for i in range(n):
+    d.appendleft(i)
+total = 0
+while len(d):
+    total += d.popleft()
+t1 = clock()
+print("deque appendleft/popleft " + str(total) + ": " + str(t1 - t0))
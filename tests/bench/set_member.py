@@ -0,0 +1,32 @@
+xs = []
+d = {}
+for i in range(2000):
+    xs.append("k" + str(i))
+    d["k" + str(i)] = None
+s = set(xs)
+probe = []
+for i in range(4000):
+    probe.append("k" + str(i))
+t0 = clock()
+n = 0
+for p in probe:
+    if p in xs:
+        n += 1
+t1 = clock()
+print("list in " + str(n) + ": " + str(t1 - t0))
+t0 = clock()
+n = 0
+for r in range(50):
+    for p in probe:
+        if p in d:
+            n += 1
+t1 = clock()
+print("dict in x50 " + str(n) + ": " + str(t1 - t0))
+t0 = clock()
+n = 0
+for r in range(50):
+    for p in probe:
+        if p in s:
+            n += 1
+t1 = clock()
+print("set in x50 " + str(n) + ": " + str(t1 - t0))
@@ -0,0 +1,19 @@
+n = 200000
+nums = []
+for i in range(n):
+    nums.append((i * 7919) % 100003)
+words = [str(x) for x in nums]
+t0 = clock()
+a = nums[:]
+a.sort()
+t1 = clock()
+print("sort numbers: " + str(t1 - t0))
+t0 = clock()
+a = words[:]
+a.sort()
+t1 = clock()
+print("sort strings: " + str(t1 - t0))
+t0 = clock()
+a.sort()
+t1 = clock()
+print("sort sorted strings: " + str(t1 - t0))
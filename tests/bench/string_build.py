@@ -0,0 +1,23 @@
+n = 20000
+t0 = clock()
+s = ""
+for i in range(n):
+    s = s + "line " + str(i) + "\n"
+t1 = clock()
+print("s = s + piece: " + str(t1 - t0))
+t0 = clock()
+b = builder()
+for i in range(n):
+    b.append("line ")
+    b.append(i)
+    b.append("\n")
+r = b.build()
+t1 = clock()
+print("builder: " + str(t1 - t0))
+t0 = clock()
+parts = []
+for i in range(n):
+    parts.append("line " + str(i) + "\n")
+r = "".join(parts)
+t1 = clock()
+print("join: " + str(t1 - t0))
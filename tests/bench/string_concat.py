@@ -0,0 +1,27 @@
+n = 50000
+t0 = clock()
+s = ""
+for i in range(n):
+    s = s + "piece " + str(i) + ";"
+t1 = clock()
+print("concatenate " + str(len(s)) + " bytes: " + str(t1 - t0))
+
+t0 = clock()
+s = ""
+hits = 0
+for i in range(n):
+    s = s + "piece " + str(i) + ";"
+    if s[-1] == ";":
+        hits += 1
+    if i % 100 == 0 and "piece 7;" in s:
+        hits += 1
+t1 = clock()
+print("concatenate and read: " + str(hits) + " " + str(t1 - t0))
+
+t0 = clock()
+base = "x" * 1000
+for i in range(n):
+    a = base + "a"
+    b = base + "b"
+t1 = clock()
+print("branching concatenate: " + str(t1 - t0))
@@ -0,0 +1,33 @@
+# Substring search over a multi-megabyte log-like haystack.
+#
+#   buildout/sparrow tests/bench/string_index.py
+
+lines = []
+for i in range(40000):
+    lines.append("2024-05-01 12:00:" + str(i % 60) + " INFO worker-" + str(i % 16) +
+                 " handled request id=" + str(i * 7919) + " status=200 bytes=" + str(i % 5000))
+log = "\n".join(lines)
+print("haystack bytes:", len(log))
+
+def bench(name, needle, reps):
+    t = clock()
+    for i in range(reps):
+        r = log.find(needle)
+    print(name, r, clock() - t)
+
+bench("single byte, absent     ", "#", 20)
+bench("short needle, near end  ", "id=" + str(39990 * 7919), 20)
+bench("short needle, absent    ", "status=500", 20)
+bench("long needle, absent     ", "ERROR worker-3 failed to handle request: connection reset by peer", 20)
+bench("periodic needle, absent ", "0" * 40, 20)
+
+t = clock()
+n = 0
+for line in lines:
+    if "bytes=4999" in line:
+        n += 1
+print("'in' over every line      ", n, clock() - t)
+
+t = clock()
+parts = log.split("status=200")
+print("split on short separator  ", len(parts), clock() - t)
@@ -0,0 +1,29 @@
+# Build with -U__SSE2__ to compare against the scalar loops.
+text = ("   " + "The Quick Brown Fox 0123456789 jumps\n" * 40000 + "   ")
+digits = "0123456789" * 100000
+t0 = clock()
+for i in range(50):
+    s = text.strip()
+t1 = clock()
+print("strip " + str(len(s)) + " bytes x50: " + str(t1 - t0))
+t0 = clock()
+for i in range(50):
+    r = digits.isdigit()
+t1 = clock()
+print("isdigit x50: " + str(t1 - t0))
+t0 = clock()
+for i in range(20):
+    r = text.lower()
+    r = text.upper()
+t1 = clock()
+print("lower+upper x20: " + str(t1 - t0))
+t0 = clock()
+for i in range(20):
+    r = text.translate("aeiou", "AEIOU")
+t1 = clock()
+print("translate x20: " + str(t1 - t0))
+t0 = clock()
+for i in range(50):
+    r = text.count("\n")
+t1 = clock()
+print("count " + str(r) + " x50: " + str(t1 - t0))
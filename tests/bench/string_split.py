@@ -0,0 +1,11 @@
+s = "field," * 200000
+t0 = clock()
+for i in range(20):
+    parts = s.split(",")
+t1 = clock()
+print("split " + str(len(parts)) + " pieces x20: " + str(t1 - t0))
+t0 = clock()
+for i in range(20):
+    r = s.replace(",", ";;")
+t1 = clock()
+print("replace " + str(len(r)) + " bytes x20: " + str(t1 - t0))
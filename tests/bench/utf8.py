@@ -0,0 +1,26 @@
+e = chr(0xc3) + chr(0xa9)
+euro = chr(0xe2) + chr(0x82) + chr(0xac)
+text = ("caf" + e + " au lait " + euro + "3.50\n") * 50000
+n = text.ulen()
+print("bytes " + str(len(text)) + " code points " + str(n))
+t0 = clock()
+for i in range(20):
+    r = text.isutf8()
+t1 = clock()
+print("isutf8 x20: " + str(t1 - t0))
+t0 = clock()
+for i in range(20):
+    r = text.ulen()
+t1 = clock()
+print("ulen x20: " + str(t1 - t0))
+t0 = clock()
+j = 0
+for i in range(100000):
+    j = (j + 7919) % n
+    c = text.uat(j)
+t1 = clock()
+print("uat x100000: " + str(t1 - t0))
+t0 = clock()
+r = text.uchars()
+t1 = clock()
+print("uchars: " + str(t1 - t0))